@@ -0,0 +1,62 @@
+#! /usr/bin/env python3
+
+import os
+
+from lab.environments import LocalEnvironment, BaselSlurmEnvironment
+
+import common_setup
+from common_setup import IssueConfig, IssueExperiment
+
+BENCHMARKS_DIR = os.environ["DOWNWARD_BENCHMARKS"]
+REVISIONS = ["pareto-open-list-base", "pareto-open-list-v1"]
+
+EVALUATORS = [
+    "--evaluator", "hff=ff()",
+    "--evaluator", "hadd=add()",
+    "--evaluator", "hcg=cg()",
+    "--evaluator", "hgc=goalcount()",
+]
+CONFIGS = [
+    IssueConfig(
+        "eager-pareto-3",
+        EVALUATORS + ["--search", "eager(pareto([hff,hadd,hcg]))"]),
+    IssueConfig(
+        "eager-pareto-4",
+        EVALUATORS + ["--search", "eager(pareto([hff,hadd,hcg,hgc]))"]),
+    IssueConfig(
+        "lazy-pareto-4-uniform",
+        EVALUATORS + ["--search",
+                      "lazy(pareto([hff,hadd,hcg,hgc],"
+                      "state_uniform_selection=true))"]),
+]
+
+SUITE = common_setup.DEFAULT_SATISFICING_SUITE
+ENVIRONMENT = BaselSlurmEnvironment(
+    partition="infai_2",
+    export=["PATH", "DOWNWARD_BENCHMARKS"])
+
+if common_setup.is_test_run():
+    SUITE = IssueExperiment.DEFAULT_TEST_SUITE
+    ENVIRONMENT = LocalEnvironment(processes=2)
+
+exp = IssueExperiment(
+    revisions=REVISIONS,
+    configs=CONFIGS,
+    environment=ENVIRONMENT,
+)
+exp.add_suite(BENCHMARKS_DIR, SUITE)
+
+exp.add_parser(exp.EXITCODE_PARSER)
+exp.add_parser(exp.TRANSLATOR_PARSER)
+exp.add_parser(exp.SINGLE_SEARCH_PARSER)
+exp.add_parser(exp.PLANNER_PARSER)
+
+exp.add_step("build", exp.build)
+exp.add_step("start", exp.start_runs)
+exp.add_fetcher(name="fetch")
+
+exp.add_absolute_report_step()
+exp.add_comparison_table_step()
+exp.add_scatter_plot_step(relative=True, attributes=["search_time", "total_time"])
+
+exp.run_steps()
@@ -0,0 +1,58 @@
+#! /usr/bin/env python3
+
+import os
+
+from lab.environments import LocalEnvironment, BaselSlurmEnvironment
+
+import common_setup
+from common_setup import IssueConfig, IssueExperiment
+
+BENCHMARKS_DIR = os.environ["DOWNWARD_BENCHMARKS"]
+REVISIONS = ["relaxation-layout-base", "relaxation-layout-v1"]
+
+CONFIGS = [
+    IssueConfig(heuristic, ["--search", f"astar({heuristic}())"])
+    for heuristic in ["add", "hmax", "ff"]
+] + [
+    IssueConfig(
+        f"lazy-greedy-{heuristic}",
+        ["--evaluator", f"h={heuristic}()",
+         "--search", "lazy_greedy([h], preferred=[h])"])
+    for heuristic in ["add", "ff"]
+] + [
+    # Renumbering can change ties between best supporters and thus h^FF
+    # values. The comparison table also lists initial h values, costs and
+    # evaluations, which catch changes that expansions alone can miss.
+    IssueConfig("eager-greedy-ff", ["--search", "eager_greedy([ff()])"]),
+]
+
+SUITE = common_setup.DEFAULT_OPTIMAL_SUITE
+ENVIRONMENT = BaselSlurmEnvironment(
+    partition="infai_2",
+    export=["PATH", "DOWNWARD_BENCHMARKS"])
+
+if common_setup.is_test_run():
+    SUITE = IssueExperiment.DEFAULT_TEST_SUITE
+    ENVIRONMENT = LocalEnvironment(processes=2)
+
+exp = IssueExperiment(
+    revisions=REVISIONS,
+    configs=CONFIGS,
+    environment=ENVIRONMENT,
+)
+exp.add_suite(BENCHMARKS_DIR, SUITE)
+
+exp.add_parser(exp.EXITCODE_PARSER)
+exp.add_parser(exp.TRANSLATOR_PARSER)
+exp.add_parser(exp.SINGLE_SEARCH_PARSER)
+exp.add_parser(exp.PLANNER_PARSER)
+
+exp.add_step("build", exp.build)
+exp.add_step("start", exp.start_runs)
+exp.add_fetcher(name="fetch")
+
+exp.add_absolute_report_step()
+exp.add_comparison_table_step()
+exp.add_scatter_plot_step(relative=True, attributes=["search_time", "total_time"])
+
+exp.run_steps()
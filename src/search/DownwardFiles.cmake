@@ -116,6 +116,7 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
@@ -168,6 +169,14 @@ fast_downward_plugin(
         open_lists/type_based_open_list
 )
 
+fast_downward_plugin(
+    NAME DECISION_DIAGRAMS
+    HELP "Reduced ordered binary and algebraic decision diagrams"
+    SOURCES
+        algorithms/decision_diagrams
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME DYNAMIC_BITSET
     HELP "Poor man's version of boost::dynamic_bitset"
@@ -287,6 +296,14 @@ fast_downward_plugin(
     DEPENDS COMBINING_EVALUATOR EVALUATORS_PLUGIN_GROUP
 )
 
+fast_downward_plugin(
+    NAME MEMO_EVALUATOR
+    HELP "The memoizing evaluator"
+    SOURCES
+        evaluators/memo_evaluator
+    DEPENDS EVALUATORS_PLUGIN_GROUP
+)
+
 fast_downward_plugin(
     NAME PREF_EVALUATOR
     HELP "The pref evaluator"
@@ -473,6 +490,7 @@ fast_downward_plugin(
     SOURCES
         heuristics/array_pool
         heuristics/relaxation_heuristic
+        heuristics/relaxed_reachability
     DEPENDENCY_ONLY
 )
 
@@ -556,6 +574,24 @@ fast_downward_plugin(
     DEPENDS PRIORITY_QUEUES RELAXATION_HEURISTIC
 )
 
+fast_downward_plugin(
+    NAME RELAXED_REACHABILITY_HEURISTIC
+    HELP "The bitset-based relaxed reachability heuristic"
+    SOURCES
+        heuristics/relaxed_reachability_heuristic
+    DEPENDS RELAXATION_HEURISTIC
+)
+
+fast_downward_plugin(
+    NAME NOVELTY
+    HELP "Novelty evaluator and width-based search"
+    SOURCES
+        novelty/iw_search
+        novelty/novelty_evaluator
+        novelty/novelty_table
+    DEPENDS DYNAMIC_BITSET SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME CORE_TASKS
     HELP "Core task transformations"
@@ -731,6 +767,7 @@ fast_downward_plugin(
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
         pdbs/cegar
+        pdbs/distance_table
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
@@ -747,6 +784,7 @@ fast_downward_plugin(
         pdbs/pattern_collection_generator_multiple
         pdbs/pattern_collection_generator_systematic
         pdbs/pattern_database
+        pdbs/pdb_cache
         pdbs/pattern_generator_cegar
         pdbs/pattern_generator_greedy
         pdbs/pattern_generator_manual
@@ -754,14 +792,18 @@ fast_downward_plugin(
         pdbs/pattern_generator
         pdbs/pattern_information
         pdbs/pdb_heuristic
+        pdbs/pdb_lookup
         pdbs/plugin_group
         pdbs/random_pattern
+        pdbs/saturated_cost_partitioning
+        pdbs/saturated_cost_partitioning_heuristic
+        pdbs/symbolic_distances
         pdbs/types
         pdbs/utils
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH DECISION_DIAGRAMS MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -0,0 +1,345 @@
+#include "decision_diagrams.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+namespace decision_diagrams {
+static const size_t INITIAL_TABLE_SIZE = 1 << 16;
+static const size_t MAX_CACHE_SIZE = 1 << 22;
+
+enum Operation {
+    AND,
+    OR,
+    AND_NOT,
+    AND_EXISTS,
+    ITE_TERMINAL
+};
+
+Manager::Manager(int num_vars)
+    : num_vars(num_vars),
+      unique_table(INITIAL_TABLE_SIZE, -1),
+      cache(INITIAL_TABLE_SIZE, CacheEntry {-1, 0, 0, 0, 0}) {
+    NodeID false_id = make_terminal(0);
+    NodeID true_id = make_terminal(1);
+    assert(false_id == BDD_FALSE && true_id == BDD_TRUE);
+    (void)false_id;
+    (void)true_id;
+}
+
+size_t Manager::hash_node(int var, NodeID low, NodeID high) const {
+    uint64_t key = (static_cast<uint64_t>(low) << 32) ^
+        static_cast<uint32_t>(high) ^ (static_cast<uint64_t>(var) << 48);
+    key *= 0x9e3779b97f4a7c15ULL;
+    return (key ^ (key >> 29)) & (unique_table.size() - 1);
+}
+
+void Manager::insert_into_unique_table(NodeID id) {
+    const Node &node = nodes[id];
+    size_t mask = unique_table.size() - 1;
+    size_t slot = hash_node(node.var, node.low, node.high);
+    while (unique_table[slot] != -1)
+        slot = (slot + 1) & mask;
+    unique_table[slot] = id;
+}
+
+void Manager::grow_unique_table() {
+    unique_table.assign(2 * unique_table.size(), -1);
+    for (NodeID id = 0; id < static_cast<NodeID>(nodes.size()); ++id) {
+        if (nodes[id].var != num_vars)
+            insert_into_unique_table(id);
+    }
+    if (cache.size() < MAX_CACHE_SIZE)
+        cache.assign(2 * cache.size(), CacheEntry {-1, 0, 0, 0, 0});
+}
+
+size_t Manager::hash_cache_entry(int op, NodeID f, NodeID g, int h) const {
+    uint64_t key = (static_cast<uint64_t>(f) << 32) ^ static_cast<uint32_t>(g);
+    key = key * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(h);
+    key = key * 0xff51afd7ed558ccdULL + static_cast<uint64_t>(op);
+    return (key ^ (key >> 31)) & (cache.size() - 1);
+}
+
+bool Manager::lookup_cache(
+    int op, NodeID f, NodeID g, int h, NodeID &result) const {
+    size_t slot = hash_cache_entry(op, f, g, h);
+    const CacheEntry &entry = cache[slot];
+    if (entry.op == op && entry.f == f && entry.g == g && entry.h == h) {
+        result = entry.result;
+        return true;
+    }
+    return false;
+}
+
+void Manager::store_in_cache(int op, NodeID f, NodeID g, int h, NodeID result) {
+    size_t slot = hash_cache_entry(op, f, g, h);
+    cache[slot] = CacheEntry {op, f, g, h, result};
+}
+
+NodeID Manager::get_low(NodeID f, int var) const {
+    return nodes[f].var == var ? nodes[f].low : f;
+}
+
+NodeID Manager::get_high(NodeID f, int var) const {
+    return nodes[f].var == var ? nodes[f].high : f;
+}
+
+NodeID Manager::make_terminal(int value) {
+    auto it = terminals.find(value);
+    if (it != terminals.end())
+        return it->second;
+    NodeID id = nodes.size();
+    nodes.push_back(Node {num_vars, value, value});
+    terminals[value] = id;
+    return id;
+}
+
+NodeID Manager::make_node(int var, NodeID low, NodeID high) {
+    assert(var >= 0 && var < num_vars);
+    assert(var < nodes[low].var && var < nodes[high].var);
+    if (low == high)
+        return low;
+    size_t mask = unique_table.size() - 1;
+    for (size_t slot = hash_node(var, low, high); unique_table[slot] != -1;
+         slot = (slot + 1) & mask) {
+        const Node &node = nodes[unique_table[slot]];
+        if (node.var == var && node.low == low && node.high == high)
+            return unique_table[slot];
+    }
+    NodeID id = nodes.size();
+    nodes.push_back(Node {var, low, high});
+    if (2 * nodes.size() > unique_table.size())
+        grow_unique_table();
+    else
+        insert_into_unique_table(id);
+    return id;
+}
+
+NodeID Manager::make_literal(int var, bool value) {
+    if (value)
+        return make_node(var, BDD_FALSE, BDD_TRUE);
+    else
+        return make_node(var, BDD_TRUE, BDD_FALSE);
+}
+
+NodeID Manager::make_cube(const vector<int> &vars) {
+    vector<int> sorted_vars(vars);
+    sort(sorted_vars.begin(), sorted_vars.end());
+    NodeID cube = BDD_TRUE;
+    for (auto it = sorted_vars.rbegin(); it != sorted_vars.rend(); ++it)
+        cube = make_node(*it, BDD_FALSE, cube);
+    return cube;
+}
+
+NodeID Manager::bdd_and(NodeID f, NodeID g) {
+    if (f == BDD_FALSE || g == BDD_FALSE)
+        return BDD_FALSE;
+    if (f == BDD_TRUE || f == g)
+        return g;
+    if (g == BDD_TRUE)
+        return f;
+    if (f > g)
+        swap(f, g);
+    NodeID result;
+    if (lookup_cache(AND, f, g, 0, result))
+        return result;
+    int var = min(nodes[f].var, nodes[g].var);
+    NodeID low = bdd_and(get_low(f, var), get_low(g, var));
+    NodeID high = bdd_and(get_high(f, var), get_high(g, var));
+    result = make_node(var, low, high);
+    store_in_cache(AND, f, g, 0, result);
+    return result;
+}
+
+NodeID Manager::bdd_or(NodeID f, NodeID g) {
+    if (f == BDD_TRUE || g == BDD_TRUE)
+        return BDD_TRUE;
+    if (f == BDD_FALSE || f == g)
+        return g;
+    if (g == BDD_FALSE)
+        return f;
+    if (f > g)
+        swap(f, g);
+    NodeID result;
+    if (lookup_cache(OR, f, g, 0, result))
+        return result;
+    int var = min(nodes[f].var, nodes[g].var);
+    NodeID low = bdd_or(get_low(f, var), get_low(g, var));
+    NodeID high = bdd_or(get_high(f, var), get_high(g, var));
+    result = make_node(var, low, high);
+    store_in_cache(OR, f, g, 0, result);
+    return result;
+}
+
+NodeID Manager::bdd_and_not(NodeID f, NodeID g) {
+    if (f == BDD_FALSE || g == BDD_TRUE || f == g)
+        return BDD_FALSE;
+    if (g == BDD_FALSE)
+        return f;
+    NodeID result;
+    if (lookup_cache(AND_NOT, f, g, 0, result))
+        return result;
+    int var = min(nodes[f].var, nodes[g].var);
+    NodeID low = bdd_and_not(get_low(f, var), get_low(g, var));
+    NodeID high = bdd_and_not(get_high(f, var), get_high(g, var));
+    result = make_node(var, low, high);
+    store_in_cache(AND_NOT, f, g, 0, result);
+    return result;
+}
+
+NodeID Manager::bdd_and_exists(NodeID f, NodeID g, NodeID cube) {
+    if (f == BDD_FALSE || g == BDD_FALSE)
+        return BDD_FALSE;
+    if (f == BDD_TRUE && g == BDD_TRUE)
+        return BDD_TRUE;
+    int var = min(nodes[f].var, nodes[g].var);
+    // Skip the quantified variables that neither f nor g depend on.
+    while (nodes[cube].var < var)
+        cube = nodes[cube].high;
+    if (cube == BDD_TRUE)
+        return bdd_and(f, g);
+    if (f > g)
+        swap(f, g);
+    NodeID result;
+    if (lookup_cache(AND_EXISTS, f, g, cube, result))
+        return result;
+    if (nodes[cube].var == var) {
+        NodeID rest = nodes[cube].high;
+        NodeID low = bdd_and_exists(get_low(f, var), get_low(g, var), rest);
+        if (low == BDD_TRUE) {
+            result = BDD_TRUE;
+        } else {
+            NodeID high = bdd_and_exists(
+                get_high(f, var), get_high(g, var), rest);
+            result = bdd_or(low, high);
+        }
+    } else {
+        NodeID low = bdd_and_exists(get_low(f, var), get_low(g, var), cube);
+        NodeID high = bdd_and_exists(get_high(f, var), get_high(g, var), cube);
+        result = make_node(var, low, high);
+    }
+    store_in_cache(AND_EXISTS, f, g, cube, result);
+    return result;
+}
+
+NodeID Manager::add_ite_terminal(NodeID f, int value, NodeID g) {
+    if (f == BDD_FALSE)
+        return g;
+    if (f == BDD_TRUE)
+        return make_terminal(value);
+    NodeID result;
+    if (lookup_cache(ITE_TERMINAL, f, g, value, result))
+        return result;
+    int var = min(nodes[f].var, nodes[g].var);
+    NodeID low = add_ite_terminal(get_low(f, var), value, get_low(g, var));
+    NodeID high = add_ite_terminal(get_high(f, var), value, get_high(g, var));
+    result = make_node(var, low, high);
+    store_in_cache(ITE_TERMINAL, f, g, value, result);
+    return result;
+}
+
+double Manager::count_models_recursive(
+    NodeID f, unordered_map<NodeID, double> &counts) const {
+    const Node &node = nodes[f];
+    if (node.var == num_vars)
+        return node.low != 0 ? 1 : 0;
+    auto it = counts.find(f);
+    if (it != counts.end())
+        return it->second;
+    double low_count = count_models_recursive(node.low, counts) *
+        pow(2.0, nodes[node.low].var - node.var - 1);
+    double high_count = count_models_recursive(node.high, counts) *
+        pow(2.0, nodes[node.high].var - node.var - 1);
+    double count = low_count + high_count;
+    counts[f] = count;
+    return count;
+}
+
+double Manager::count_models(NodeID f) const {
+    unordered_map<NodeID, double> counts;
+    return count_models_recursive(f, counts) * pow(2.0, nodes[f].var);
+}
+
+void Manager::collect_garbage(const vector<NodeID *> &roots) {
+    vector<bool> reachable(nodes.size(), false);
+    reachable[BDD_FALSE] = true;
+    reachable[BDD_TRUE] = true;
+    vector<NodeID> stack;
+    for (NodeID *root : roots)
+        stack.push_back(*root);
+    while (!stack.empty()) {
+        NodeID id = stack.back();
+        stack.pop_back();
+        if (reachable[id])
+            continue;
+        reachable[id] = true;
+        if (nodes[id].var != num_vars) {
+            stack.push_back(nodes[id].low);
+            stack.push_back(nodes[id].high);
+        }
+    }
+
+    /*
+      Children are created before their parents and thus have smaller
+      IDs, so we can assign the new IDs in one pass.
+    */
+    vector<NodeID> new_ids(nodes.size(), -1);
+    NodeID num_kept = 0;
+    for (NodeID id = 0; id < static_cast<NodeID>(nodes.size()); ++id) {
+        if (!reachable[id])
+            continue;
+        Node node = nodes[id];
+        if (node.var != num_vars) {
+            node.low = new_ids[node.low];
+            node.high = new_ids[node.high];
+            assert(node.low != -1 && node.high != -1);
+        }
+        new_ids[id] = num_kept;
+        nodes[num_kept++] = node;
+    }
+    nodes.resize(num_kept);
+    nodes.shrink_to_fit();
+    for (NodeID *root : roots)
+        *root = new_ids[*root];
+
+    terminals.clear();
+    fill(unique_table.begin(), unique_table.end(), -1);
+    for (NodeID id = 0; id < num_kept; ++id) {
+        if (nodes[id].var == num_vars)
+            terminals[nodes[id].low] = id;
+        else
+            insert_into_unique_table(id);
+    }
+    fill(cache.begin(), cache.end(), CacheEntry {-1, 0, 0, 0, 0});
+}
+
+vector<Node> Manager::extract(NodeID f) const {
+    unordered_map<NodeID, NodeID> new_ids;
+    vector<NodeID> old_ids;
+    new_ids[f] = 0;
+    old_ids.push_back(f);
+    for (size_t i = 0; i < old_ids.size(); ++i) {
+        const Node &node = nodes[old_ids[i]];
+        if (node.var == num_vars)
+            continue;
+        for (NodeID child : {node.low, node.high}) {
+            if (new_ids.emplace(child, old_ids.size()).second)
+                old_ids.push_back(child);
+        }
+    }
+    vector<Node> result;
+    result.reserve(old_ids.size());
+    for (NodeID old_id : old_ids) {
+        Node node = nodes[old_id];
+        if (node.var != num_vars) {
+            node.low = new_ids[node.low];
+            node.high = new_ids[node.high];
+        }
+        result.push_back(node);
+    }
+    return result;
+}
+}
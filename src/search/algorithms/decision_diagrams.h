@@ -0,0 +1,115 @@
+#ifndef ALGORITHMS_DECISION_DIAGRAMS_H
+#define ALGORITHMS_DECISION_DIAGRAMS_H
+
+#include <unordered_map>
+#include <vector>
+
+namespace decision_diagrams {
+using NodeID = int;
+
+/*
+  A node of a decision diagram over the ordered binary variables
+  0, ..., num_vars - 1. Inner nodes test variable var and continue with
+  low if it is false and with high if it is true. Terminal nodes have
+  var == num_vars and store their value in low.
+*/
+struct Node {
+    int var;
+    NodeID low;
+    NodeID high;
+};
+
+/*
+  A small package for reduced ordered algebraic decision diagrams (ADDs)
+  with integer terminals. Binary decision diagrams (BDDs) are the ADDs
+  whose terminals are 0 (false) and 1 (true). All diagrams of a manager
+  share their nodes, which are identified by their IDs: equivalent
+  diagrams have the same ID. Results of operations are cached in a lossy
+  computed table.
+
+  Nodes are never freed individually. Instead, collect_garbage() removes
+  all nodes that are not reachable from the given roots, which changes
+  the IDs of the remaining nodes. Diagrams that outlive the manager can
+  be copied with extract().
+*/
+class Manager {
+    struct CacheEntry {
+        int op;
+        NodeID f;
+        NodeID g;
+        int h;
+        NodeID result;
+    };
+
+    int num_vars;
+    std::vector<Node> nodes;
+    // Open-addressing hash table of the IDs of inner nodes (-1 if unused).
+    std::vector<NodeID> unique_table;
+    std::unordered_map<int, NodeID> terminals;
+    std::vector<CacheEntry> cache;
+
+    std::size_t hash_node(int var, NodeID low, NodeID high) const;
+    void insert_into_unique_table(NodeID id);
+    void grow_unique_table();
+    std::size_t hash_cache_entry(int op, NodeID f, NodeID g, int h) const;
+    bool lookup_cache(int op, NodeID f, NodeID g, int h, NodeID &result) const;
+    void store_in_cache(int op, NodeID f, NodeID g, int h, NodeID result);
+    NodeID get_low(NodeID f, int var) const;
+    NodeID get_high(NodeID f, int var) const;
+    double count_models_recursive(
+        NodeID f, std::unordered_map<NodeID, double> &counts) const;
+public:
+    static const NodeID BDD_FALSE = 0;
+    static const NodeID BDD_TRUE = 1;
+
+    explicit Manager(int num_vars);
+
+    int get_num_vars() const {
+        return num_vars;
+    }
+
+    int get_num_nodes() const {
+        return nodes.size();
+    }
+
+    NodeID make_terminal(int value);
+    // Return the node testing var, or low if low == high.
+    NodeID make_node(int var, NodeID low, NodeID high);
+
+    // BDD that is true iff var has the given value.
+    NodeID make_literal(int var, bool value);
+    // Conjunction of the positive literals of the given variables.
+    NodeID make_cube(const std::vector<int> &vars);
+
+    // Operations on BDDs.
+    NodeID bdd_and(NodeID f, NodeID g);
+    NodeID bdd_or(NodeID f, NodeID g);
+    // f and not g
+    NodeID bdd_and_not(NodeID f, NodeID g);
+    // Existential quantification of the variables in cube over (f and g).
+    NodeID bdd_and_exists(NodeID f, NodeID g, NodeID cube);
+
+    /*
+      Return the ADD that maps all assignments satisfying the BDD f to
+      value and all others to the value of the ADD g.
+    */
+    NodeID add_ite_terminal(NodeID f, int value, NodeID g);
+
+    // Number of assignments to all variables that satisfy the BDD f.
+    double count_models(NodeID f) const;
+
+    /*
+      Remove all nodes that are not reachable from the given roots and
+      update the roots to the new IDs of their nodes.
+    */
+    void collect_garbage(const std::vector<NodeID *> &roots);
+
+    /*
+      Return the nodes reachable from f with consecutive IDs, where the
+      root has ID 0.
+    */
+    std::vector<Node> extract(NodeID f) const;
+};
+}
+
+#endif
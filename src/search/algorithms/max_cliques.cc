@@ -1,110 +1,228 @@
 #include "max_cliques.h"
 
-#include "../utils/collections.h"
-#include "../utils/logging.h"
-
 #include <algorithm>
+#include <bitset>
 #include <cassert>
-#include <iostream>
-#include <iterator>
+#include <cstdint>
 #include <vector>
 
 using namespace std;
 
 namespace max_cliques {
+/*
+  Sets of vertices are bit vectors with 64 vertices per block. Each set
+  used by the algorithm has the same number of blocks.
+*/
+using Block = uint64_t;
+static const int BITS_PER_BLOCK = 64;
+
+static int count_bits(Block block) {
+    return bitset<BITS_PER_BLOCK>(block).count();
+}
+
+// Call callback for the elements of the given set in increasing order.
+template<typename Callback>
+static void for_each_vertex(
+    const Block *set, int num_blocks, const Callback &callback) {
+    for (int i = 0; i < num_blocks; ++i) {
+        Block block = set[i];
+        while (block) {
+            Block lowest_bit = block & (~block + 1);
+            callback(i * BITS_PER_BLOCK + count_bits(lowest_bit - 1));
+            block ^= lowest_bit;
+        }
+    }
+}
+
+static bool is_empty(const Block *set, int num_blocks) {
+    for (int i = 0; i < num_blocks; ++i) {
+        if (set[i])
+            return false;
+    }
+    return true;
+}
+
 class MaxCliqueComputer {
     const vector<vector<int>> &graph;
     vector<vector<int>> &max_cliques;
+    int num_vertices;
+    int num_blocks;
+    // The neighbors of vertex v are stored in blocks [v * num_blocks, ...).
+    vector<Block> neighbors;
     vector<int> current_max_clique;
+    /*
+      For recursion depth d, the candidates, the excluded vertices and the
+      vertices to branch over, each stored in num_blocks blocks.
+    */
+    vector<vector<Block>> sets_by_depth;
+
+    const Block *get_neighbors(int v) const {
+        return &neighbors[v * num_blocks];
+    }
+
+    /*
+      Choose the vertex u from candidates and excluded vertices that has
+      the most neighbors among the candidates, so that the algorithm only
+      needs to branch over the candidates that are not neighbors of u.
+    */
+    int get_pivot(const Block *candidates, const Block *excluded) const {
+        int pivot = -1;
+        int max_num_neighbors = -1;
+        auto consider = [&](int u) {
+                const Block *u_neighbors = get_neighbors(u);
+                int num_neighbors = 0;
+                for (int i = 0; i < num_blocks; ++i) {
+                    num_neighbors += count_bits(candidates[i] & u_neighbors[i]);
+                }
+                if (num_neighbors > max_num_neighbors) {
+                    max_num_neighbors = num_neighbors;
+                    pivot = u;
+                }
+            };
+        for_each_vertex(candidates, num_blocks, consider);
+        for_each_vertex(excluded, num_blocks, consider);
+        assert(pivot != -1);
+        return pivot;
+    }
 
-    int get_maximizing_vertex(
-        const vector<int> &subg, const vector<int> &cand) {
-        assert(utils::is_sorted_unique(subg));
-        assert(utils::is_sorted_unique(cand));
-
-        //utils::g_log << "subg: " << subg << endl;
-        //utils::g_log << "cand: " << cand << endl;
-        size_t max = 0;
-        // We will take the first vertex if there is no better one.
-        int vertex = subg[0];
-
-        for (size_t i = 0; i < subg.size(); ++i) {
-            vector<int> intersection;
-            intersection.reserve(subg.size());
-            // for vertex u in subg get u's adjacent vertices: graph[subg[i]];
-            set_intersection(cand.begin(), cand.end(),
-                             graph[subg[i]].begin(), graph[subg[i]].end(),
-                             back_inserter(intersection));
-
-            if (intersection.size() > max) {
-                max = intersection.size();
-                vertex = subg[i];
-                //utils::g_log << "success: there is a maximizing vertex." << endl;
+    /*
+      Report all maximal cliques that extend current_max_clique by
+      candidates and contain no excluded vertex. The sets are stored in
+      sets_by_depth[depth] and modified.
+    */
+    void expand(int depth) {
+        Block *candidates = sets_by_depth[depth].data();
+        Block *excluded = candidates + num_blocks;
+        Block *branch_vertices = excluded + num_blocks;
+        if (is_empty(candidates, num_blocks)) {
+            if (is_empty(excluded, num_blocks)) {
+                max_cliques.push_back(current_max_clique);
             }
+            return;
         }
-        return vertex;
-    }
 
-    void expand(vector<int> &subg, vector<int> &cand) {
-        // utils::g_log << "subg: " << subg << endl;
-        // utils::g_log << "cand: " << cand << endl;
-        if (subg.empty()) {
-            //utils::g_log << "clique" << endl;
-            max_cliques.push_back(current_max_clique);
-        } else {
-            int u = get_maximizing_vertex(subg, cand);
-
-            vector<int> ext_u;
-            ext_u.reserve(cand.size());
-            set_difference(cand.begin(), cand.end(),
-                           graph[u].begin(), graph[u].end(),
-                           back_inserter(ext_u));
-
-            while (!ext_u.empty()) {
-                int q = ext_u.back();
-                ext_u.pop_back();
-                //utils::g_log << q << ",";
-                current_max_clique.push_back(q);
-
-                // subg_q = subg n gamma(q)
-                vector<int> subg_q;
-                subg_q.reserve(subg.size());
-                set_intersection(subg.begin(), subg.end(),
-                                 graph[q].begin(), graph[q].end(),
-                                 back_inserter(subg_q));
-
-                // cand_q = cand n gamma(q)
-                vector<int> cand_q;
-                cand_q.reserve(cand.size());
-                set_intersection(cand.begin(), cand.end(),
-                                 graph[q].begin(), graph[q].end(),
-                                 back_inserter(cand_q));
-                expand(subg_q, cand_q);
-
-                // remove q from cand --> cand = cand - q
-                cand.erase(lower_bound(cand.begin(), cand.end(), q));
-
-                //utils::g_log << "back" << endl;
+        const Block *pivot_neighbors = get_neighbors(
+            get_pivot(candidates, excluded));
+        for (int i = 0; i < num_blocks; ++i) {
+            branch_vertices[i] = candidates[i] & ~pivot_neighbors[i];
+        }
+        if (static_cast<int>(sets_by_depth.size()) == depth + 1) {
+            sets_by_depth.emplace_back(3 * num_blocks);
+        }
+        /*
+          Adding sets for deeper levels moves the vectors in sets_by_depth
+          but not their data, so the pointers stay valid.
+        */
+        for_each_vertex(
+            branch_vertices, num_blocks, [&](int v) {
+                const Block *v_neighbors = get_neighbors(v);
+                Block *next_candidates = sets_by_depth[depth + 1].data();
+                Block *next_excluded = next_candidates + num_blocks;
+                for (int i = 0; i < num_blocks; ++i) {
+                    next_candidates[i] = candidates[i] & v_neighbors[i];
+                    next_excluded[i] = excluded[i] & v_neighbors[i];
+                }
+                current_max_clique.push_back(v);
+                expand(depth + 1);
                 current_max_clique.pop_back();
+                candidates[v / BITS_PER_BLOCK] &= ~(Block(1) << (v % BITS_PER_BLOCK));
+                excluded[v / BITS_PER_BLOCK] |= Block(1) << (v % BITS_PER_BLOCK);
+            });
+    }
+
+    /*
+      Order the vertices such that each vertex has few neighbors that come
+      later in the order by repeatedly removing a vertex of minimum degree.
+    */
+    vector<int> compute_degeneracy_order() const {
+        vector<int> degrees(num_vertices);
+        int max_degree = 0;
+        for (int v = 0; v < num_vertices; ++v) {
+            degrees[v] = graph[v].size();
+            max_degree = max(max_degree, degrees[v]);
+        }
+        // Vertices by degree; entries with outdated degrees are skipped.
+        vector<vector<int>> buckets(max_degree + 1);
+        for (int v = 0; v < num_vertices; ++v) {
+            buckets[degrees[v]].push_back(v);
+        }
+        vector<bool> removed(num_vertices, false);
+        vector<int> order;
+        order.reserve(num_vertices);
+        int degree = 0;
+        while (static_cast<int>(order.size()) < num_vertices) {
+            if (buckets[degree].empty()) {
+                ++degree;
+                continue;
             }
+            int v = buckets[degree].back();
+            buckets[degree].pop_back();
+            if (removed[v] || degrees[v] != degree)
+                continue;
+            removed[v] = true;
+            order.push_back(v);
+            for (int u : graph[v]) {
+                if (!removed[u]) {
+                    --degrees[u];
+                    buckets[degrees[u]].push_back(u);
+                }
+            }
+            // Removing v can only decrease the minimum degree by one.
+            degree = max(0, degree - 1);
         }
+        return order;
     }
 
 public:
     MaxCliqueComputer(const vector<vector<int>> &graph_,
                       vector<vector<int>> &max_cliques_)
-        : graph(graph_), max_cliques(max_cliques_) {
+        : graph(graph_),
+          max_cliques(max_cliques_),
+          num_vertices(graph.size()),
+          num_blocks((num_vertices + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK) {
+        neighbors.assign(num_vertices * num_blocks, 0);
+        for (int v = 0; v < num_vertices; ++v) {
+            for (int u : graph[v]) {
+                assert(u != v);
+                neighbors[v * num_blocks + u / BITS_PER_BLOCK] |=
+                    Block(1) << (u % BITS_PER_BLOCK);
+            }
+        }
     }
 
     void compute() {
-        vector<int> vertices_1;
-        vertices_1.reserve(graph.size());
-        for (size_t i = 0; i < graph.size(); ++i) {
-            vertices_1.push_back(i);
+        if (num_vertices == 0) {
+            // The empty clique is the only maximal clique.
+            max_cliques.emplace_back();
+            return;
+        }
+        /*
+          Every maximal clique is reported from its first vertex in the
+          degeneracy order v. The candidates are the neighbors of v that
+          come later in the order and the excluded vertices are the
+          neighbors that come earlier. The number of candidates is bounded
+          by the degeneracy of the graph, which is small for sparse graphs.
+        */
+        vector<int> order = compute_degeneracy_order();
+        vector<Block> later(num_blocks, 0);
+        for (int v : order) {
+            later[v / BITS_PER_BLOCK] |= Block(1) << (v % BITS_PER_BLOCK);
+        }
+        sets_by_depth.assign(1, vector<Block>(3 * num_blocks));
+        current_max_clique.reserve(num_vertices);
+        for (int v : order) {
+            later[v / BITS_PER_BLOCK] &= ~(Block(1) << (v % BITS_PER_BLOCK));
+            const Block *v_neighbors = get_neighbors(v);
+            Block *candidates = sets_by_depth[0].data();
+            Block *excluded = candidates + num_blocks;
+            for (int i = 0; i < num_blocks; ++i) {
+                candidates[i] = v_neighbors[i] & later[i];
+                excluded[i] = v_neighbors[i] & ~later[i];
+            }
+            current_max_clique.push_back(v);
+            expand(0);
+            current_max_clique.pop_back();
         }
-        vector<int> vertices_2(vertices_1);
-        current_max_clique.reserve(graph.size());
-        expand(vertices_1, vertices_2);
     }
 };
 
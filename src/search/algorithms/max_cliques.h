@@ -4,20 +4,26 @@
 #include <vector>
 
 namespace max_cliques {
-/* Implementation of the Max Cliques algorithm by Tomita et al. See:
+/*
+  Compute all maximal cliques of the given undirected graph, which is
+  given by the adjacency list of each vertex. The cliques are
+  reported in no particular order. A graph without vertices has the empty
+  clique as its only maximal clique.
+
+  We use the Bron-Kerbosch algorithm with the pivoting rule by Tomita et
+  al. on bit vectors, called for each vertex in a degeneracy ordering of
+  the graph as suggested by Eppstein et al. See:
 
    Etsuji Tomita, Akira Tanaka and Haruhisa Takahashi, The Worst-Case
    Time Complexity for Generating All Maximal Cliques. Proceedings of
    the 10th Annual International Conference on Computing and
    Combinatorics (COCOON 2004), pp. 161-170, 2004.
 
-   In the paper the authors use a compressed output of the cliques,
-   such that the algorithm is in O(3^{n/3}).
-
-   This implementation is in O(n 3^{n/3}) because the cliques are
-   output explicitly. For a better runtime it could be useful to
-   use bit vectors instead of vectors.
- */
+   David Eppstein, Maarten Loeffler and Darren Strash, Listing All
+   Maximal Cliques in Sparse Graphs in Near-Optimal Time. Proceedings of
+   the 21st International Symposium on Algorithms and Computation (ISAAC
+   2010), pp. 403-414, 2010.
+*/
 extern void compute_max_cliques(
     const std::vector<std::vector<int>> &graph,
     std::vector<std::vector<int>> &max_cliques);
@@ -25,6 +25,10 @@ bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+bool Evaluator::get_relevant_variables(set<int> &) const {
+    return false;
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result) const {
     if (log.is_at_least_normal()) {
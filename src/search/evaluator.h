@@ -6,6 +6,7 @@
 #include "../utils/logging.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -52,6 +53,16 @@ public:
         std::set<Evaluator *> &evals) = 0;
 
 
+    /*
+      get_relevant_variables should insert the IDs of all variables whose
+      values can influence the estimate for a state into the result set
+      and return true. Variable IDs refer to the root task. Evaluators
+      that cannot report such a set, e.g., because their estimates depend
+      on the path to the state, return false. The default implementation
+      returns false.
+    */
+    virtual bool get_relevant_variables(std::set<int> &variables) const;
+
     virtual void notify_initial_state(const State & /*initial_state*/) {
     }
 
@@ -61,6 +72,17 @@ public:
         const State & /*state*/) {
     }
 
+    /*
+      precompute_estimates is called with a batch of states that are about
+      to be evaluated. Evaluators that can compute estimates for many
+      states at once more cheaply than one at a time may do so here and
+      answer the following compute_result calls from their own storage.
+      Composite evaluators forward the call to their subevaluators. The
+      default implementation does nothing.
+    */
+    virtual void precompute_estimates(const std::vector<State> & /*states*/) {
+    }
+
     /*
       compute_result should compute the estimate and possibly
       preferred operators for the given evaluation context and return
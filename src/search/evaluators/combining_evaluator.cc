@@ -52,6 +52,19 @@ void CombiningEvaluator::get_path_dependent_evaluators(
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+bool CombiningEvaluator::get_relevant_variables(set<int> &variables) const {
+    for (auto &subevaluator : subevaluators)
+        if (!subevaluator->get_relevant_variables(variables))
+            return false;
+    return true;
+}
+
+void CombiningEvaluator::precompute_estimates(const vector<State> &states) {
+    for (auto &subevaluator : subevaluators)
+        subevaluator->precompute_estimates(states);
+}
+
 void add_combining_evaluator_options_to_parser(options::OptionParser &parser) {
     parser.add_list_option<shared_ptr<Evaluator>>(
         "evals", "at least one evaluator");
@@ -41,6 +41,10 @@ public:
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
+    virtual bool get_relevant_variables(
+        std::set<int> &variables) const override;
+    virtual void precompute_estimates(
+        const std::vector<State> &states) override;
 };
 
 extern void add_combining_evaluator_options_to_parser(
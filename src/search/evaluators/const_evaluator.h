@@ -19,6 +19,9 @@ public:
     explicit ConstEvaluator(const options::Options &opts);
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &) override {}
+    virtual bool get_relevant_variables(std::set<int> &) const override {
+        return true;
+    }
     virtual ~ConstEvaluator() override = default;
 };
 }
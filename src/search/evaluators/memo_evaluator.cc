@@ -0,0 +1,293 @@
+#include "memo_evaluator.h"
+
+#include "../evaluation_context.h"
+#include "../evaluation_result.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../tasks/root_task.h"
+#include "../utils/collections.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/math.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+namespace memo_evaluator {
+// Number of slots (starting at the home slot) in which a key may be stored.
+static const size_t PROBE_LIMIT = 8;
+/*
+  After PROBATION_LOOKUPS lookups, a hash table is switched off as soon as
+  less than one in MIN_HIT_RATE_INVERSE lookups has hit.
+*/
+static const int PROBATION_LOOKUPS = 10000;
+static const int MIN_HIT_RATE_INVERSE = 10;
+
+enum SlotState : uint8_t {
+    EMPTY,
+    OCCUPIED,
+    REFERENCED
+};
+
+MemoEvaluator::MemoEvaluator(const Options &opts)
+    : Evaluator(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      num_key_words(0),
+      num_lookups(0),
+      num_hits(0),
+      num_evictions(0),
+      num_entries(0) {
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "memo() does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+
+    TaskProxy task_proxy(*tasks::g_root_task);
+    VariablesProxy task_variables = task_proxy.get_variables();
+    if (opts.contains("variables")) {
+        variables = opts.get_list<int>("variables");
+        for (int var : variables) {
+            if (var < 0 || var >= static_cast<int>(task_variables.size())) {
+                cerr << "Invalid variable id for memo(): " << var << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+        }
+        sort(variables.begin(), variables.end());
+        variables.erase(unique(variables.begin(), variables.end()),
+                        variables.end());
+    } else {
+        set<int> relevant_variables;
+        if (!evaluator->get_relevant_variables(relevant_variables)) {
+            cerr << "The evaluator " << evaluator->get_description()
+                 << " cannot report its relevant variables. "
+                 << "Please specify them with memo(..., variables=[...])."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        variables.assign(relevant_variables.begin(), relevant_variables.end());
+    }
+
+    int max_size = opts.get<int>("max_size");
+    int num_projected_states = 1;
+    for (int var : variables) {
+        int domain_size = task_variables[var].get_domain_size();
+        if (!utils::is_product_within_limit(
+                num_projected_states, domain_size, max_size)) {
+            num_projected_states = -1;
+            break;
+        }
+        multipliers.push_back(num_projected_states);
+        num_projected_states *= domain_size;
+    }
+
+    is_direct = (num_projected_states != -1);
+    if (is_direct) {
+        capacity = num_projected_states;
+    } else {
+        utils::release_vector_memory(multipliers);
+        // Pack the values into words without splitting them across words.
+        num_key_words = 1;
+        int bits_used = 0;
+        for (int var : variables) {
+            int domain_size = task_variables[var].get_domain_size();
+            int bits = 0;
+            while ((1 << bits) < domain_size)
+                ++bits;
+            if (bits_used + bits > 64) {
+                ++num_key_words;
+                bits_used = 0;
+            }
+            key_words.push_back(num_key_words - 1);
+            key_shifts.push_back(bits_used);
+            bits_used += bits;
+        }
+        // Use the largest power of two that does not exceed max_size.
+        capacity = 1;
+        while (2 * capacity <= static_cast<size_t>(max_size))
+            capacity *= 2;
+        keys.resize(capacity * num_key_words);
+        key.resize(num_key_words);
+    }
+    values.resize(capacity);
+    slot_states.resize(capacity, EMPTY);
+
+    if (log.is_at_least_normal()) {
+        log << "Memoizing " << evaluator->get_description() << " on "
+            << variables.size() << " variables in a "
+            << (is_direct ? "direct table" : "hash table")
+            << " with " << capacity << " entries" << endl;
+    }
+}
+
+MemoEvaluator::~MemoEvaluator() {
+    if (log.is_at_least_normal()) {
+        log << "Memo lookups: " << num_lookups << endl;
+        log << "Memo hits: " << num_hits << endl;
+        if (num_lookups > 0) {
+            log << "Memo hit rate: "
+                << 100.0 * num_hits / num_lookups << "%" << endl;
+        }
+        log << "Memo entries: " << num_entries << endl;
+        log << "Memo evictions: " << num_evictions << endl;
+        if (capacity == 0)
+            log << "Memo switched off because of low hit rate" << endl;
+    }
+}
+
+void MemoEvaluator::compute_key(const State &state) {
+    fill(key.begin(), key.end(), 0);
+    for (size_t i = 0; i < variables.size(); ++i) {
+        uint64_t value = state[variables[i]].get_value();
+        key[key_words[i]] |= value << key_shifts[i];
+    }
+}
+
+bool MemoEvaluator::lookup(const State &state, size_t &slot) {
+    if (is_direct) {
+        slot = 0;
+        for (size_t i = 0; i < variables.size(); ++i)
+            slot += multipliers[i] * state[variables[i]].get_value();
+        assert(slot < capacity);
+        return slot_states[slot] != EMPTY;
+    }
+
+    compute_key(state);
+    utils::HashState hash_state;
+    for (uint64_t word : key)
+        utils::feed(hash_state, word);
+    size_t mask = capacity - 1;
+    size_t home = hash_state.get_hash32() & mask;
+    size_t window = min(PROBE_LIMIT, capacity);
+    for (size_t i = 0; i < window; ++i) {
+        slot = (home + i) & mask;
+        if (slot_states[slot] == EMPTY)
+            return false;
+        if (equal(key.begin(), key.end(),
+                  keys.begin() + slot * num_key_words)) {
+            slot_states[slot] = REFERENCED;
+            return true;
+        }
+    }
+
+    // The window is full: give referenced entries a second chance.
+    for (size_t i = 0; i < window; ++i) {
+        slot = (home + i) & mask;
+        if (slot_states[slot] == OCCUPIED)
+            return false;
+        slot_states[slot] = OCCUPIED;
+    }
+    slot = home;
+    return false;
+}
+
+void MemoEvaluator::store(size_t slot, int value) {
+    if (slot_states[slot] == EMPTY)
+        ++num_entries;
+    else
+        ++num_evictions;
+    if (!is_direct)
+        copy(key.begin(), key.end(), keys.begin() + slot * num_key_words);
+    values[slot] = value;
+    slot_states[slot] = OCCUPIED;
+}
+
+void MemoEvaluator::disable_if_ineffective() {
+    if (!is_direct && num_lookups >= PROBATION_LOOKUPS &&
+        num_hits * MIN_HIT_RATE_INVERSE < num_lookups) {
+        capacity = 0;
+        utils::release_vector_memory(keys);
+        utils::release_vector_memory(values);
+        utils::release_vector_memory(slot_states);
+    }
+}
+
+bool MemoEvaluator::dead_ends_are_reliable() const {
+    return evaluator->dead_ends_are_reliable();
+}
+
+EvaluationResult MemoEvaluator::compute_result(
+    EvaluationContext &eval_context) {
+    // Note that this produces no preferred operators.
+    EvaluationResult result;
+    size_t slot;
+    if (capacity == 0) {
+        result.set_evaluator_value(
+            eval_context.get_evaluator_value_or_infinity(evaluator.get()));
+    } else if (lookup(eval_context.get_state(), slot)) {
+        ++num_lookups;
+        ++num_hits;
+        result.set_evaluator_value(values[slot]);
+    } else {
+        ++num_lookups;
+        int value = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+        store(slot, value);
+        result.set_evaluator_value(value);
+        disable_if_ineffective();
+    }
+    return result;
+}
+
+void MemoEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
+    evaluator->get_path_dependent_evaluators(evals);
+}
+
+bool MemoEvaluator::get_relevant_variables(set<int> &relevant_variables) const {
+    relevant_variables.insert(variables.begin(), variables.end());
+    return true;
+}
+
+void MemoEvaluator::precompute_estimates(const vector<State> &states) {
+    if (capacity == 0) {
+        evaluator->precompute_estimates(states);
+        return;
+    }
+    // Only pass on the states whose values are not cached.
+    vector<State> uncached_states;
+    for (const State &state : states) {
+        size_t slot;
+        if (!lookup(state, slot))
+            uncached_states.push_back(state);
+    }
+    if (!uncached_states.empty())
+        evaluator->precompute_estimates(uncached_states);
+}
+
+static shared_ptr<Evaluator> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Memoizing evaluator",
+        "Caches the values of the evaluator for the projections of the "
+        "evaluated states onto the given variables. This is only correct "
+        "if the values of the evaluator only depend on these variables. "
+        "If no variables are given, the evaluator has to report the "
+        "variables it depends on itself, which is supported by the "
+        "goal count heuristic, the PDB heuristics and the basic evaluators "
+        "combining them. Path-dependent evaluators are not supported.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator");
+    parser.add_list_option<int>(
+        "variables",
+        "variables on which the values of the evaluator depend "
+        "(derived from the evaluator if omitted)",
+        OptionParser::NONE);
+    parser.add_option<int>(
+        "max_size",
+        "maximum number of cached values",
+        "1000000",
+        Bounds("1", "infinity"));
+    add_evaluator_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<MemoEvaluator>(opts);
+}
+
+static Plugin<Evaluator> _plugin("memo", _parse, "evaluators_basic");
+}
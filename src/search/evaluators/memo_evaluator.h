@@ -0,0 +1,73 @@
+#ifndef EVALUATORS_MEMO_EVALUATOR_H
+#define EVALUATORS_MEMO_EVALUATOR_H
+
+#include "../evaluator.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace memo_evaluator {
+/*
+  Caches the values of an evaluator whose estimates only depend on the
+  values of a set of variables, so that states that agree on these
+  variables are only evaluated once.
+
+  If all projected states fit into the cache, the values are stored in a
+  table indexed by the mixed-radix encoding of the projected state.
+  Otherwise, the projected state is packed into a key of 64-bit words and
+  stored in a bounded open-addressing hash table. A key can only be
+  stored within a small window of slots following its home slot, and
+  when the window is full, one of its slots is replaced following the
+  clock algorithm (entries that have been looked up since the last pass
+  get a second chance). Since a hash table only costs time and memory if
+  projected states rarely repeat, it is switched off if its hit rate is
+  low after a number of lookups.
+*/
+class MemoEvaluator : public Evaluator {
+    std::shared_ptr<Evaluator> evaluator;
+    std::vector<int> variables;
+
+    bool is_direct;
+    // Number of slots (0 if the cache has been switched off).
+    std::size_t capacity;
+    // Mixed-radix multipliers of the variables (direct table only).
+    std::vector<int> multipliers;
+    // Position of each variable in the packed key (hash table only).
+    std::vector<int> key_words;
+    std::vector<int> key_shifts;
+    int num_key_words;
+
+    std::vector<std::uint64_t> keys;
+    std::vector<int> values;
+    std::vector<std::uint8_t> slot_states;
+    std::vector<std::uint64_t> key;
+
+    std::int64_t num_lookups;
+    std::int64_t num_hits;
+    std::int64_t num_evictions;
+    std::int64_t num_entries;
+
+    void compute_key(const State &state);
+    bool lookup(const State &state, std::size_t &slot);
+    void store(std::size_t slot, int value);
+    void disable_if_ineffective();
+
+public:
+    explicit MemoEvaluator(const options::Options &opts);
+    virtual ~MemoEvaluator() override;
+
+    virtual bool dead_ends_are_reliable() const override;
+    virtual EvaluationResult compute_result(
+        EvaluationContext &eval_context) override;
+    virtual void get_path_dependent_evaluators(std::set<Evaluator *> &evals) override;
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
+    virtual void precompute_estimates(const std::vector<State> &states) override;
+};
+}
+
+#endif
@@ -41,6 +41,14 @@ void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+bool WeightedEvaluator::get_relevant_variables(set<int> &variables) const {
+    return evaluator->get_relevant_variables(variables);
+}
+
+void WeightedEvaluator::precompute_estimates(const vector<State> &states) {
+    evaluator->precompute_estimates(states);
+}
+
 static shared_ptr<Evaluator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Weighted evaluator",
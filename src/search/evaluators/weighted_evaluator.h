@@ -22,6 +22,8 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
     virtual void get_path_dependent_evaluators(std::set<Evaluator *> &evals) override;
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
+    virtual void precompute_estimates(const std::vector<State> &states) override;
 };
 }
 
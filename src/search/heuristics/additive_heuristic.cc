@@ -17,10 +17,29 @@ const int AdditiveHeuristic::MAX_COST_VALUE;
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      incremental(opts.get<bool>("incremental")),
+      has_previous_exploration(false) {
     if (log.is_at_least_normal()) {
         log << "Initializing additive heuristic..." << endl;
     }
+    if (incremental) {
+        build_achievers();
+    }
+}
+
+void AdditiveHeuristic::build_achievers() {
+    vector<vector<OpID>> achievers_by_prop(propositions.size());
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        achievers_by_prop[unary_operators[op_id].effect].push_back(op_id);
+    }
+    achievers.reserve(propositions.size());
+    num_achievers.reserve(propositions.size());
+    for (const vector<OpID> &prop_achievers : achievers_by_prop) {
+        achievers.push_back(achievers_pool.append(prop_achievers));
+        num_achievers.push_back(prop_achievers.size());
+    }
 }
 
 void AdditiveHeuristic::write_overflow_warning() {
@@ -40,19 +59,12 @@ void AdditiveHeuristic::write_overflow_warning() {
 // heuristic computation
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions) {
-        prop.cost = -1;
-        prop.marked = false;
-    }
+    reset_exploration_states();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator &op = unary_operators[op_id];
+        enqueue_if_necessary(op.effect, op.base_cost, op_id);
     }
 }
 
@@ -69,30 +81,153 @@ void AdditiveHeuristic::relaxed_exploration() {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = get_proposition_state(prop_id)->cost;
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        const Proposition *prop = get_proposition(prop_id);
+        // In incremental mode, the next evaluation needs all costs.
+        if (prop->is_goal && --unsolved_goals == 0 && !incremental)
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, op_id);
+            OperatorState *op_state = get_operator_state(op_id);
+            increase_cost(op_state->cost, prop_cost);
+            --op_state->unsatisfied_preconditions;
+            assert(op_state->unsatisfied_preconditions >= 0);
+            if (op_state->unsatisfied_preconditions == 0)
+                enqueue_if_necessary(unary_operators[op_id].effect,
+                                     op_state->cost, op_id);
+        }
+    }
+}
+
+int AdditiveHeuristic::compute_operator_cost(OpID op_id) {
+    int cost = unary_operators[op_id].base_cost;
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = proposition_states[precond].cost;
+        if (precond_cost == -1)
+            return -1;
+        increase_cost(cost, precond_cost);
+    }
+    return cost;
+}
+
+bool AdditiveHeuristic::collect_changed_facts(const State &state) {
+    /*
+      Collect the facts that differ between the state of the previous
+      exploration and the given state. Return false if there is no
+      previous exploration or if so many facts changed that repairing the
+      exploration is not worth it.
+    */
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    if (!has_previous_exploration) {
+        previous_state_values = values;
+        has_previous_exploration = true;
+        return false;
+    }
+    removed_props.clear();
+    added_props.clear();
+    int num_vars = values.size();
+    for (int var = 0; var < num_vars; ++var) {
+        if (values[var] != previous_state_values[var]) {
+            removed_props.push_back(get_prop_id(var, previous_state_values[var]));
+            added_props.push_back(get_prop_id(var, values[var]));
+            previous_state_values[var] = values[var];
         }
     }
+    return 2 * static_cast<int>(removed_props.size()) <= num_vars;
+}
+
+void AdditiveHeuristic::invalidate_affected_propositions() {
+    /*
+      A proposition is affected if its best supporter depends on a removed
+      fact. We reset the costs of all affected propositions. All other
+      propositions keep costs that are achievable in the new state.
+    */
+    affected_props.clear();
+    for (PropID prop_id : removed_props) {
+        PropositionState *prop_state = get_proposition_state(prop_id);
+        prop_state->cost = -1;
+        prop_state->reached_by = NO_OP;
+        affected_props.push_back(prop_id);
+    }
+    for (size_t i = 0; i < affected_props.size(); ++i) {
+        const Proposition *prop = get_proposition(affected_props[i]);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            PropID effect_id = unary_operators[op_id].effect;
+            PropositionState *effect = get_proposition_state(effect_id);
+            if (effect->cost != -1 && effect->reached_by == op_id) {
+                effect->cost = -1;
+                effect->reached_by = NO_OP;
+                affected_props.push_back(effect_id);
+            }
+        }
+    }
+}
+
+void AdditiveHeuristic::update_exploration() {
+    queue.clear();
+    invalidate_affected_propositions();
+
+    // Recompute the costs of affected propositions from unaffected ones.
+    for (PropID prop_id : affected_props) {
+        PropositionState *prop_state = get_proposition_state(prop_id);
+        for (OpID op_id : achievers_pool.get_slice(
+                 achievers[prop_id], num_achievers[prop_id])) {
+            int op_cost = compute_operator_cost(op_id);
+            if (op_cost != -1 &&
+                (prop_state->cost == -1 || op_cost < prop_state->cost)) {
+                prop_state->cost = op_cost;
+                prop_state->reached_by = op_id;
+            }
+        }
+        if (prop_state->cost != -1)
+            queue.push(prop_state->cost, prop_id);
+    }
+
+    for (PropID prop_id : added_props) {
+        PropositionState *prop_state = get_proposition_state(prop_id);
+        prop_state->cost = 0;
+        prop_state->reached_by = NO_OP;
+        queue.push(0, prop_id);
+    }
+
+    // Propagate the changed costs.
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        assert(get_proposition_state(prop_id)->cost >= 0);
+        if (get_proposition_state(prop_id)->cost < distance)
+            continue;
+        const Proposition *prop = get_proposition(prop_id);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            int op_cost = compute_operator_cost(op_id);
+            if (op_cost == -1)
+                continue;
+            PropID effect_id = unary_operators[op_id].effect;
+            PropositionState *effect = get_proposition_state(effect_id);
+            if (effect->cost == -1 || effect->cost > op_cost) {
+                effect->cost = op_cost;
+                effect->reached_by = op_id;
+                queue.push(op_cost, effect_id);
+            }
+        }
+    }
+
+    for (PropositionState &prop_state : proposition_states) {
+        prop_state.marked = false;
+    }
 }
 
 void AdditiveHeuristic::mark_preferred_operators(
     const State &state, PropID goal_id) {
-    Proposition *goal = get_proposition(goal_id);
+    PropositionState *goal = get_proposition_state(goal_id);
     if (!goal->marked) { // Only consider each subgoal once.
         goal->marked = true;
         OpID op_id = goal->reached_by;
@@ -101,7 +236,7 @@ void AdditiveHeuristic::mark_preferred_operators(
             bool is_preferred = true;
             for (PropID precond : get_preconditions(op_id)) {
                 mark_preferred_operators(state, precond);
-                if (get_proposition(precond)->reached_by != NO_OP) {
+                if (get_proposition_state(precond)->reached_by != NO_OP) {
                     is_preferred = false;
                 }
             }
@@ -117,14 +252,20 @@ void AdditiveHeuristic::mark_preferred_operators(
 }
 
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (is_filtered_dead_end(state))
+        return DEAD_END;
+
+    if (incremental && collect_changed_facts(state)) {
+        update_exploration();
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = get_proposition_state(goal_id)->cost;
         if (goal_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, goal_cost);
@@ -146,6 +287,19 @@ void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
 
+void AdditiveHeuristic::add_incremental_option_to_parser(OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental",
+        "keep the complete relaxed exploration of the last evaluated state "
+        "and only repair the parts affected by the facts in which the next "
+        "evaluated state differs. This pays off if consecutively evaluated "
+        "states are similar, e.g. siblings in greedy best-first search. "
+        "Ties between best supporters may be broken differently than in "
+        "the non-incremental computation, which can change preferred "
+        "operators and relaxed plans.",
+        "false");
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Additive heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -160,6 +314,8 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
+    AdditiveHeuristic::add_incremental_option_to_parser(parser);
+    AdditiveHeuristic::add_dead_end_filter_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -7,6 +7,7 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <vector>
 
 class State;
 
@@ -16,7 +17,9 @@ using relaxation_heuristic::OpID;
 
 using relaxation_heuristic::NO_OP;
 
+using relaxation_heuristic::OperatorState;
 using relaxation_heuristic::Proposition;
+using relaxation_heuristic::PropositionState;
 using relaxation_heuristic::UnaryOperator;
 
 class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
@@ -32,20 +35,43 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
 
+    /*
+      In incremental mode, the exploration is always run to completion and
+      kept for the next evaluation. The next state is then handled by
+      repairing the costs of the propositions that depend on facts that
+      are no longer true and propagating the cost decreases caused by the
+      new facts (see update_exploration()).
+    */
+    const bool incremental;
+    bool has_previous_exploration;
+    std::vector<int> previous_state_values;
+    // achievers_pool[achievers[prop_id]] are the unary operators achieving prop_id.
+    array_pool::ArrayPool achievers_pool;
+    std::vector<array_pool::ArrayPoolIndex> achievers;
+    std::vector<int> num_achievers;
+    std::vector<PropID> removed_props;
+    std::vector<PropID> added_props;
+    std::vector<PropID> affected_props;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+    void build_achievers();
+    int compute_operator_cost(OpID op_id);
+    bool collect_changed_facts(const State &state);
+    void invalidate_affected_propositions();
+    void update_exploration();
     void mark_preferred_operators(const State &state, PropID goal_id);
 
     void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
         assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op_id;
+        PropositionState *prop_state = get_proposition_state(prop_id);
+        if (prop_state->cost == -1 || prop_state->cost > cost) {
+            prop_state->cost = cost;
+            prop_state->reached_by = op_id;
             queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_state->cost != -1 && prop_state->cost <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
@@ -60,6 +86,10 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void write_overflow_warning();
 protected:
+    bool is_incremental() const {
+        return incremental;
+    }
+
     virtual int compute_heuristic(const State &ancestor_state) override;
 
     // Common part of h^add and h^ff computation.
@@ -75,8 +105,10 @@ public:
     */
     void compute_heuristic_for_cegar(const State &state);
 
+    static void add_incremental_option_to_parser(options::OptionParser &parser);
+
     int get_cost_for_cegar(int var, int value) const {
-        return get_proposition(var, value)->cost;
+        return get_proposition_state(get_prop_id(var, value))->cost;
     }
 };
 }
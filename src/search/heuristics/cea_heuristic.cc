@@ -7,7 +7,9 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -31,149 +33,110 @@ using namespace domain_transition_graph;
      Keeps track of how many unachieved preconditions there still are,
      what the cost of enabling the transition are and things like that.
 
-   The following two design decisions might be worth revisiting:
+   Local problems, nodes, transitions, node contexts and waiting list
+   entries are stored in one arena vector each and refer to each other
+   by index. The nodes of a local problem, the outgoing transitions of a
+   node and the context of a node are contiguous ranges of the
+   respective arenas. Waiting lists are linked lists in waiting_entries,
+   which is cleared before each evaluation. Instead of resetting all
+   local problems before each evaluation, each problem remembers the
+   epoch (evaluation number) for which it was set up last.
+
+   The following design decision might be worth revisiting:
    - Each local problem keeps its own copy of the graph itself
      (what is connected to what via which labels), even though this
      is not necessary. The "static" graph info and the "dynamic" info
      could be split, potentially saving quite a bit of memory.
-   - The graph is encoded with reference cycles: each transition knows
-     what its source node is, even though this is in a sense redundant
-     (the source must be the node which holds the transition), and
-     every node knows what its local problem is, which is similarly
-     redundant (the local problem must be the one that holds this node).
-     If we got rid of this, the main queue of the algorithm would need
-     (LocalProblem *, LocalProblemNode *) pairs rather than straight
-     node pointers, and the waiting lists would need to contain
-     (LocalProblemNode *, LocalTransition *) pairs rather than straight
-     transitions. So it's not clear if this would really save much, which
-     is why we do not currently do it.
  */
 namespace cea_heuristic {
-struct LocalTransition {
-    LocalProblemNode *source;
-    LocalProblemNode *target;
-    const ValueTransitionLabel *label;
-    int action_cost;
-
-    int target_cost;
-    int unreached_conditions;
-
-    LocalTransition(
-        LocalProblemNode *source_, LocalProblemNode *target_,
-        const ValueTransitionLabel *label_, int action_cost_)
-        : source(source_), target(target_),
-          label(label_), action_cost(action_cost_),
-          target_cost(-1), unreached_conditions(-1) {
-        // target_cost and unreached_cost are initialized by
-        // expand_transition.
-    }
-
-    ~LocalTransition() {
-    }
-};
-
-
-struct LocalProblemNode {
-    // Attributes fixed during initialization.
-    LocalProblem *owner;
-    vector<LocalTransition> outgoing_transitions;
-
-    // Dynamic attributes (modified during heuristic computation).
-    int cost;
-    bool expanded;
-    vector<short> context;
-
-    LocalTransition *reached_by;
-    /* Before a node is expanded, reached_by is the "current best"
-       transition leading to this node. After a node is expanded, the
-       reached_by value of the parent is copied (unless the parent is
-       the initial node), so that reached_by is the *first* transition
-       on the optimal path to this node. This is useful for preferred
-       operators. (The two attributes used to be separate, but this
-       was a bit wasteful.) */
-
-    vector<LocalTransition *> waiting_list;
-
-    LocalProblemNode(LocalProblem *owner_, int context_size)
-        : owner(owner_),
-          cost(-1),
-          expanded(false),
-          context(context_size, -1),
-          reached_by(0) {
-    }
-
-    ~LocalProblemNode() {
-    }
-};
-
-struct LocalProblem {
-    int base_priority;
-    vector<LocalProblemNode> nodes;
-    vector<int> *context_variables;
-public:
-    LocalProblem()
-        : base_priority(-1) {
-    }
-
-    ~LocalProblem() {
-    }
-};
-
-LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
+int ContextEnhancedAdditiveHeuristic::get_local_problem(
     int var_no, int value) {
-    LocalProblem * &table_entry = local_problem_index[var_no][value];
-    if (!table_entry) {
+    int &table_entry = local_problem_index[var_no][value];
+    if (table_entry == -1)
         table_entry = build_problem_for_variable(var_no);
-        local_problems.push_back(table_entry);
-    }
     return table_entry;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
-
-    DomainTransitionGraph *dtg = transition_graphs[var_no].get();
+int ContextEnhancedAdditiveHeuristic::add_local_problem(
+    const vector<int> *context_variables, int num_values) {
+    int problem_id = local_problems.size();
+    int nodes_begin = nodes.size();
+    local_problems.push_back(
+        {-1, -1, nodes_begin, nodes_begin + num_values, context_variables});
+    int context_size = context_variables->size();
+    for (int value = 0; value < num_values; ++value) {
+        LocalProblemNode node;
+        node.owner = problem_id;
+        node.transitions_begin = node.transitions_end = 0;
+        node.context_begin = contexts.size();
+        node.cost = -1;
+        node.expanded = false;
+        node.reached_by = NO_TRANSITION;
+        node.waiting_head = node.waiting_tail = NO_ENTRY;
+        nodes.push_back(node);
+        contexts.insert(contexts.end(), context_size, -1);
+    }
+    return problem_id;
+}
 
-    problem->context_variables = &dtg->local_to_global_child;
+void ContextEnhancedAdditiveHeuristic::add_transition(
+    int source, int target, const ValueTransitionLabel &label,
+    const vector<int> &context_variables, int action_cost) {
+    LocalTransition trans;
+    trans.source = source;
+    trans.target = target;
+    trans.label = &label;
+    trans.action_cost = action_cost;
+    trans.preconditions_begin = local_facts.size();
+    for (const LocalAssignment &precond : label.precond)
+        local_facts.push_back({precond.local_var,
+                               context_variables[precond.local_var],
+                               precond.value});
+    trans.effects_begin = local_facts.size();
+    for (const LocalAssignment &effect : label.effect)
+        local_facts.push_back({effect.local_var, -1, effect.value});
+    trans.effects_end = local_facts.size();
+    trans.target_cost = -1;
+    trans.unreached_conditions = -1;
+    transitions.push_back(trans);
+}
 
-    int num_parents = problem->context_variables->size();
-    size_t num_values = task_proxy.get_variables()[var_no].get_domain_size();
-    problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+int ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
+    int var_no) {
+    DomainTransitionGraph *dtg = transition_graphs[var_no].get();
+    int num_values = task_proxy.get_variables()[var_no].get_domain_size();
+    int problem_id = add_local_problem(&dtg->local_to_global_child, num_values);
+    int nodes_begin = local_problems[problem_id].nodes_begin;
 
     // Compile the DTG arcs into LocalTransition objects.
-    for (size_t value = 0; value < num_values; ++value) {
-        LocalProblemNode &node = problem->nodes[value];
+    for (int value = 0; value < num_values; ++value) {
+        int node_id = nodes_begin + value;
+        nodes[node_id].transitions_begin = transitions.size();
         const ValueNode &dtg_node = dtg->nodes[value];
         for (size_t i = 0; i < dtg_node.transitions.size(); ++i) {
             const ValueTransition &dtg_trans = dtg_node.transitions[i];
-            int target_value = dtg_trans.target->value;
-            LocalProblemNode &target = problem->nodes[target_value];
+            int target_id = nodes_begin + dtg_trans.target->value;
             for (const ValueTransitionLabel &label : dtg_trans.labels) {
                 OperatorProxy op = label.is_axiom ?
                     task_proxy.get_axioms()[label.op_id] :
                     task_proxy.get_operators()[label.op_id];
-                LocalTransition trans(&node, &target, &label, op.get_cost());
-                node.outgoing_transitions.push_back(trans);
+                add_transition(node_id, target_id, label,
+                               dtg->local_to_global_child, op.get_cost());
             }
         }
+        nodes[node_id].transitions_end = transitions.size();
     }
-    return problem;
+    return problem_id;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
-
+int ContextEnhancedAdditiveHeuristic::build_problem_for_goal() {
     GoalsProxy goals_proxy = task_proxy.get_goals();
 
-    problem->context_variables = new vector<int>;
     for (FactProxy goal : goals_proxy)
-        problem->context_variables->push_back(goal.get_variable().get_id());
+        goal_context_variables.push_back(goal.get_variable().get_id());
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, goals_proxy.size()));
+    int problem_id = add_local_problem(&goal_context_variables, 2);
+    int nodes_begin = local_problems[problem_id].nodes_begin;
 
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < goals_proxy.size(); ++goal_no) {
@@ -181,14 +144,17 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
         goals.push_back(LocalAssignment(goal_no, goal_value));
     }
     vector<LocalAssignment> no_effects;
-    ValueTransitionLabel *label = new ValueTransitionLabel(0, true, goals, no_effects);
-    LocalTransition trans(&problem->nodes[0], &problem->nodes[1], label, 0);
-    problem->nodes[0].outgoing_transitions.push_back(trans);
-    return problem;
+    goal_label = utils::make_unique_ptr<ValueTransitionLabel>(
+        0, true, goals, no_effects);
+    LocalProblemNode &start = nodes[nodes_begin];
+    start.transitions_begin = transitions.size();
+    add_transition(nodes_begin, nodes_begin + 1, *goal_label,
+                   goal_context_variables, 0);
+    start.transitions_end = transitions.size();
+    return problem_id;
 }
 
-int ContextEnhancedAdditiveHeuristic::get_priority(
-    LocalProblemNode *node) const {
+int ContextEnhancedAdditiveHeuristic::get_priority(int node_id) const {
     /* Nodes have both a "cost" and a "priority", which are related.
        The cost is an estimate of how expensive it is to reach this
        node. The "priority" is the lowest cost value in the overall
@@ -196,174 +162,205 @@ int ContextEnhancedAdditiveHeuristic::get_priority(
        essentially the sum of the cost and a local-problem-specific
        "base priority", which depends on where this local problem is
        needed for the overall computation. */
-    return node->owner->base_priority + node->cost;
+    const LocalProblemNode &node = nodes[node_id];
+    return local_problems[node.owner].base_priority + node.cost;
 }
 
 inline void ContextEnhancedAdditiveHeuristic::initialize_heap() {
     node_queue.clear();
 }
 
-inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
-    LocalProblemNode *node) {
-    node_queue.push(get_priority(node), node);
+inline void ContextEnhancedAdditiveHeuristic::add_to_heap(int node_id) {
+    node_queue.push(get_priority(node_id), node_id);
 }
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
-    const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    int problem_id) const {
+    return local_problems[problem_id].epoch == current_epoch;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
-    LocalProblem *problem, int base_priority,
+    int problem_id, int base_priority,
     int start_value, const State &state) {
-    assert(problem->base_priority == -1);
-    problem->base_priority = base_priority;
-
-    for (auto &to_node : problem->nodes) {
+    LocalProblem &problem = local_problems[problem_id];
+    assert(problem.epoch != current_epoch);
+    problem.epoch = current_epoch;
+    problem.base_priority = base_priority;
+
+    int nodes_begin = problem.nodes_begin;
+    for (int node_id = nodes_begin; node_id < problem.nodes_end; ++node_id) {
+        LocalProblemNode &to_node = nodes[node_id];
         to_node.expanded = false;
         to_node.cost = numeric_limits<int>::max();
-        to_node.waiting_list.clear();
-        to_node.reached_by = 0;
+        to_node.waiting_head = to_node.waiting_tail = NO_ENTRY;
+        to_node.reached_by = NO_TRANSITION;
     }
 
-    LocalProblemNode *start = &problem->nodes[start_value];
-    start->cost = 0;
-    for (size_t i = 0; i < problem->context_variables->size(); ++i)
-        start->context[i] = state[(*problem->context_variables)[i]].get_value();
+    int start_id = nodes_begin + start_value;
+    LocalProblemNode &start = nodes[start_id];
+    start.cost = 0;
+    const vector<int> &context_variables = *problem.context_variables;
+    short *context = &contexts[start.context_begin];
+    for (size_t i = 0; i < context_variables.size(); ++i)
+        context[i] = state[context_variables[i]].get_value();
 
-    add_to_heap(start);
+    add_to_heap(start_id);
 }
 
-void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
-    LocalTransition *trans) {
-    if (!trans->unreached_conditions) {
-        LocalProblemNode *target = trans->target;
-        if (trans->target_cost < target->cost) {
-            target->cost = trans->target_cost;
-            target->reached_by = trans;
-            add_to_heap(target);
+inline void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
+    int trans_id) {
+    const LocalTransition &trans = transitions[trans_id];
+    if (!trans.unreached_conditions) {
+        LocalProblemNode &target = nodes[trans.target];
+        if (trans.target_cost < target.cost) {
+            target.cost = trans.target_cost;
+            target.reached_by = trans_id;
+            add_to_heap(trans.target);
         }
     }
 }
 
-void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
-    node->expanded = true;
+void ContextEnhancedAdditiveHeuristic::expand_node(int node_id) {
+    LocalProblemNode &node = nodes[node_id];
+    node.expanded = true;
     // Set context unless this was an initial node.
-    LocalTransition *reached_by = node->reached_by;
-    if (reached_by) {
-        LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
-        const vector<LocalAssignment> &precond = reached_by->label->precond;
-        for (size_t i = 0; i < precond.size(); ++i)
-            context[precond[i].local_var] = precond[i].value;
-        const vector<LocalAssignment> &effect = reached_by->label->effect;
-        for (size_t i = 0; i < effect.size(); ++i)
-            context[effect[i].local_var] = effect[i].value;
-        if (parent->reached_by)
-            node->reached_by = parent->reached_by;
+    int reached_by = node.reached_by;
+    if (reached_by != NO_TRANSITION) {
+        const LocalTransition &trans = transitions[reached_by];
+        const LocalProblemNode &parent = nodes[trans.source];
+        int context_size =
+            local_problems[node.owner].context_variables->size();
+        short *context = &contexts[node.context_begin];
+        const short *parent_context = &contexts[parent.context_begin];
+        copy(parent_context, parent_context + context_size, context);
+        // Preconditions and effects are consecutive.
+        for (int i = trans.preconditions_begin; i < trans.effects_end; ++i)
+            context[local_facts[i].local_var] = local_facts[i].value;
+        if (parent.reached_by != NO_TRANSITION)
+            node.reached_by = parent.reached_by;
     }
-    for (size_t i = 0; i < node->waiting_list.size(); ++i) {
-        LocalTransition *trans = node->waiting_list[i];
-        assert(trans->unreached_conditions);
-        --trans->unreached_conditions;
-        trans->target_cost += node->cost;
-        try_to_fire_transition(trans);
+    for (int entry = node.waiting_head; entry != NO_ENTRY;
+         entry = waiting_entries[entry].next) {
+        LocalTransition &trans = transitions[waiting_entries[entry].transition];
+        assert(trans.unreached_conditions);
+        --trans.unreached_conditions;
+        trans.target_cost += node.cost;
+        try_to_fire_transition(waiting_entries[entry].transition);
     }
-    node->waiting_list.clear();
+    node.waiting_head = node.waiting_tail = NO_ENTRY;
 }
 
 void ContextEnhancedAdditiveHeuristic::expand_transition(
-    LocalTransition *trans, const State &state) {
+    int trans_id, const State &state) {
     /* Called when the source of trans is reached by Dijkstra
        exploration. Try to compute cost for the target of the
        transition from the source cost, action cost, and set-up costs
        for the conditions on the label. The latter may yet be unknown,
        in which case we "subscribe" to the waiting list of the node
-       that will tell us the correct value. */
-
-    assert(trans->source->cost >= 0);
-    assert(trans->source->cost < numeric_limits<int>::max());
-
-    trans->target_cost = trans->source->cost + trans->action_cost;
-
-    if (trans->target->cost <= trans->target_cost) {
-        // Transition cannot find a shorter path to target.
-        return;
-    }
-
-    trans->unreached_conditions = 0;
-    const vector<LocalAssignment> &precond = trans->label->precond;
-
-    vector<LocalAssignment>::const_iterator
-        curr_precond = precond.begin(),
-        last_precond = precond.end();
-
-    vector<short>::const_iterator context = trans->source->context.begin();
-    vector<int>::const_iterator parent_vars =
-        trans->source->owner->context_variables->begin();
-
-    for (; curr_precond != last_precond; ++curr_precond) {
-        int local_var = curr_precond->local_var;
-        int current_val = context[local_var];
-        int precond_value = curr_precond->value;
-        int precond_var_no = parent_vars[local_var];
-
+       that will tell us the correct value.
+
+       compute_costs only calls this for transitions that can improve
+       the cost of their target given the source and action costs.
+
+       Setting up a subproblem may create it and thereby reallocate the
+       arenas, so we access the transition and nodes by index only. */
+    int source_id = transitions[trans_id].source;
+    int target_id = transitions[trans_id].target;
+    int source_cost = nodes[source_id].cost;
+    assert(source_cost >= 0);
+    assert(source_cost < numeric_limits<int>::max());
+
+    int target_cost = source_cost + transitions[trans_id].action_cost;
+    assert(nodes[target_id].cost > target_cost);
+
+    int unreached_conditions = 0;
+    int preconditions_begin = transitions[trans_id].preconditions_begin;
+    int preconditions_end = transitions[trans_id].effects_begin;
+    int context_begin = nodes[source_id].context_begin;
+
+    for (int i = preconditions_begin; i < preconditions_end; ++i) {
+        const LocalFact &precond = local_facts[i];
+        int current_val = contexts[context_begin + precond.local_var];
+        int precond_value = precond.value;
         if (current_val == precond_value)
             continue;
+        int precond_var_no = precond.var;
 
-        LocalProblem *subproblem = get_local_problem(
-            precond_var_no, current_val);
+        int subproblem = get_local_problem(precond_var_no, current_val);
 
         if (!is_local_problem_set_up(subproblem)) {
             set_up_local_problem(
-                subproblem, get_priority(trans->source), current_val, state);
+                subproblem, get_priority(source_id), current_val, state);
         }
 
-        LocalProblemNode *cond_node = &subproblem->nodes[precond_value];
-        if (cond_node->expanded) {
-            trans->target_cost += cond_node->cost;
-            if (trans->target->cost <= trans->target_cost) {
+        int cond_node_id =
+            local_problems[subproblem].nodes_begin + precond_value;
+        LocalProblemNode &cond_node = nodes[cond_node_id];
+        if (cond_node.expanded) {
+            target_cost += cond_node.cost;
+            if (nodes[target_id].cost <= target_cost) {
                 // Transition cannot find a shorter path to target.
+                LocalTransition &trans = transitions[trans_id];
+                trans.target_cost = target_cost;
+                trans.unreached_conditions = unreached_conditions;
                 return;
             }
         } else {
-            cond_node->waiting_list.push_back(trans);
-            ++trans->unreached_conditions;
+            int entry = waiting_entries.size();
+            waiting_entries.push_back({trans_id, NO_ENTRY});
+            if (cond_node.waiting_tail == NO_ENTRY)
+                cond_node.waiting_head = entry;
+            else
+                waiting_entries[cond_node.waiting_tail].next = entry;
+            cond_node.waiting_tail = entry;
+            ++unreached_conditions;
         }
     }
-    try_to_fire_transition(trans);
+    LocalTransition &trans = transitions[trans_id];
+    trans.target_cost = target_cost;
+    trans.unreached_conditions = unreached_conditions;
+    try_to_fire_transition(trans_id);
 }
 
 int ContextEnhancedAdditiveHeuristic::compute_costs(const State &state) {
     while (!node_queue.empty()) {
-        pair<int, LocalProblemNode *> top_pair = node_queue.pop();
+        pair<int, int> top_pair = node_queue.pop();
         int curr_priority = top_pair.first;
-        LocalProblemNode *node = top_pair.second;
+        int node_id = top_pair.second;
 
-        assert(is_local_problem_set_up(node->owner));
-        if (get_priority(node) < curr_priority)
+        assert(is_local_problem_set_up(nodes[node_id].owner));
+        if (get_priority(node_id) < curr_priority)
             continue;
-        if (node == goal_node)
-            return node->cost;
-
-        assert(get_priority(node) == curr_priority);
-        expand_node(node);
-        for (auto &transition : node->outgoing_transitions)
-            expand_transition(&transition, state);
+        if (node_id == goal_node)
+            return nodes[node_id].cost;
+
+        assert(get_priority(node_id) == curr_priority);
+        expand_node(node_id);
+        int cost = nodes[node_id].cost;
+        int transitions_begin = nodes[node_id].transitions_begin;
+        int transitions_end = nodes[node_id].transitions_end;
+        for (int trans_id = transitions_begin; trans_id < transitions_end;
+             ++trans_id) {
+            const LocalTransition &trans = transitions[trans_id];
+            // Skip transitions that cannot find a shorter path to target.
+            if (nodes[trans.target].cost > cost + trans.action_cost)
+                expand_transition(trans_id, state);
+        }
     }
     return DEAD_END;
 }
 
 void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
-    LocalProblem *problem, LocalProblemNode *node, const State &state) {
-    assert(node->cost >= 0 && node->cost < numeric_limits<int>::max());
-    LocalTransition *first_on_path = node->reached_by;
-    if (first_on_path) {
-        node->reached_by = 0; // Clear to avoid revisiting this node later.
-        if (first_on_path->target_cost == first_on_path->action_cost) {
+    int problem_id, int node_id, const State &state) {
+    LocalProblemNode &node = nodes[node_id];
+    assert(node.cost >= 0 && node.cost < numeric_limits<int>::max());
+    int first_on_path = node.reached_by;
+    if (first_on_path != NO_TRANSITION) {
+        node.reached_by = NO_TRANSITION; // Clear to avoid revisiting this node later.
+        const LocalTransition &trans = transitions[first_on_path];
+        if (trans.target_cost == trans.action_cost) {
             // Transition possibly applicable.
-            const ValueTransitionLabel &label = *first_on_path->label;
+            const ValueTransitionLabel &label = *trans.label;
             OperatorProxy op = label.is_axiom ?
                 task_proxy.get_axioms()[label.op_id] :
                 task_proxy.get_operators()[label.op_id];
@@ -375,16 +372,18 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
             }
         } else {
             // Recursively compute helpful transitions for preconditions.
-            int *context_vars = &*problem->context_variables->begin();
-            for (const auto &assignment : first_on_path->label->precond) {
+            const vector<int> &context_vars =
+                *local_problems[problem_id].context_variables;
+            for (const auto &assignment : trans.label->precond) {
                 int precond_value = assignment.value;
                 int local_var = assignment.local_var;
                 int precond_var_no = context_vars[local_var];
                 if (state[precond_var_no].get_value() == precond_value)
                     continue;
-                LocalProblem *subproblem = get_local_problem(
+                int subproblem = get_local_problem(
                     precond_var_no, state[precond_var_no].get_value());
-                LocalProblemNode *subnode = &subproblem->nodes[precond_value];
+                int subnode = local_problems[subproblem].nodes_begin +
+                    precond_value;
                 mark_helpful_transitions(subproblem, subnode, state);
             }
         }
@@ -395,9 +394,8 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    waiting_entries.clear();
+    ++current_epoch;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -412,6 +410,7 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     const Options &opts)
     : Heuristic(opts),
+      current_epoch(0),
       min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
     if (log.is_at_least_normal()) {
         log << "Initializing context-enhanced additive heuristic..." << endl;
@@ -421,23 +420,15 @@ ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     transition_graphs = factory.build_dtgs();
 
     goal_problem = build_problem_for_goal();
-    goal_node = &goal_problem->nodes[1];
+    goal_node = local_problems[goal_problem].nodes_begin + 1;
 
     VariablesProxy vars = task_proxy.get_variables();
     local_problem_index.resize(vars.size());
     for (VariableProxy var : vars)
-        local_problem_index[var.get_id()].resize(var.get_domain_size(), 0);
+        local_problem_index[var.get_id()].resize(var.get_domain_size(), -1);
 }
 
 ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
-    if (goal_problem) {
-        delete goal_problem->context_variables;
-        delete goal_problem->nodes[0].outgoing_transitions[0].label;
-    }
-    delete goal_problem;
-
-    for (LocalProblem *problem : local_problems)
-        delete problem;
 }
 
 bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
@@ -7,44 +7,129 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <memory>
 #include <vector>
 
 class State;
 
 namespace cea_heuristic {
-struct LocalProblem;
-struct LocalProblemNode;
-struct LocalTransition;
+/*
+  All local problems, their nodes, transitions and contexts live in
+  arena vectors owned by the heuristic and refer to each other by index.
+  Since the arenas grow when local problems are created lazily,
+  references into them must not be kept across calls to
+  get_local_problem().
+*/
+const int NO_TRANSITION = -1;
+const int NO_ENTRY = -1;
+
+/*
+  Precondition or effect of a transition label. For preconditions, var is
+  the global variable of local_var in the context of the source node.
+*/
+struct LocalFact {
+    int local_var;
+    int var;
+    int value;
+};
+
+struct LocalTransition {
+    int source;
+    int target;
+    const domain_transition_graph::ValueTransitionLabel *label;
+    int action_cost;
+    // Preconditions and effects of the label are consecutive in local_facts.
+    int preconditions_begin;
+    int effects_begin;
+    int effects_end;
+
+    // Dynamic attributes, initialized by expand_transition.
+    int target_cost;
+    int unreached_conditions;
+};
+
+struct LocalProblemNode {
+    // Attributes fixed during initialization.
+    int owner;
+    int transitions_begin;
+    int transitions_end;
+    int context_begin;
+
+    // Dynamic attributes (modified during heuristic computation).
+    int cost;
+    bool expanded;
+
+    int reached_by;
+    /* Before a node is expanded, reached_by is the "current best"
+       transition leading to this node. After a node is expanded, the
+       reached_by value of the parent is copied (unless the parent is
+       the initial node), so that reached_by is the *first* transition
+       on the optimal path to this node. This is useful for preferred
+       operators. (The two attributes used to be separate, but this
+       was a bit wasteful.) */
+
+    // Waiting list as a FIFO list in waiting_entries.
+    int waiting_head;
+    int waiting_tail;
+};
+
+struct LocalProblem {
+    int base_priority;
+    // The problem is set up for the current evaluation iff epoch matches.
+    int epoch;
+    int nodes_begin;
+    int nodes_end;
+    const std::vector<int> *context_variables;
+};
+
+struct WaitingEntry {
+    int transition;
+    int next;
+};
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
-    std::vector<LocalProblem *> local_problems;
-    std::vector<std::vector<LocalProblem *>> local_problem_index;
-    LocalProblem *goal_problem;
-    LocalProblemNode *goal_node;
+    std::vector<LocalProblem> local_problems;
+    std::vector<LocalProblemNode> nodes;
+    std::vector<LocalTransition> transitions;
+    std::vector<LocalFact> local_facts;
+    std::vector<short> contexts;
+    std::vector<WaitingEntry> waiting_entries;
+    std::vector<std::vector<int>> local_problem_index;
+    std::vector<int> goal_context_variables;
+    std::unique_ptr<domain_transition_graph::ValueTransitionLabel> goal_label;
+    int goal_problem;
+    int goal_node;
+    int current_epoch;
     int min_action_cost;
 
-    priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
+    priority_queues::AdaptiveQueue<int> node_queue;
 
-    LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
-    LocalProblem *build_problem_for_goal() const;
+    int get_local_problem(int var_no, int value);
+    int add_local_problem(const std::vector<int> *context_variables,
+                          int num_values);
+    void add_transition(int source, int target,
+                        const domain_transition_graph::ValueTransitionLabel &label,
+                        const std::vector<int> &context_variables,
+                        int action_cost);
+    int build_problem_for_variable(int var_no);
+    int build_problem_for_goal();
 
-    int get_priority(LocalProblemNode *node) const;
+    int get_priority(int node_id) const;
     void initialize_heap();
-    void add_to_heap(LocalProblemNode *node);
+    void add_to_heap(int node_id);
 
-    bool is_local_problem_set_up(const LocalProblem *problem) const;
-    void set_up_local_problem(LocalProblem *problem, int base_priority,
+    bool is_local_problem_set_up(int problem_id) const;
+    void set_up_local_problem(int problem_id, int base_priority,
                               int start_value, const State &state);
 
-    void try_to_fire_transition(LocalTransition *trans);
-    void expand_node(LocalProblemNode *node);
-    void expand_transition(LocalTransition *trans, const State &state);
+    void try_to_fire_transition(int trans_id);
+    void expand_node(int node_id);
+    void expand_transition(int trans_id, const State &state);
 
     int compute_costs(const State &state);
-    void mark_helpful_transitions(
-        LocalProblem *problem, LocalProblemNode *node, const State &state);
+    void mark_helpful_transitions(int problem_id, int node_id,
+                                  const State &state);
     // Clears "reached_by" of visited nodes as a side effect to avoid
     // recursing to the same node again.
 protected:
@@ -4,6 +4,8 @@
 
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
+#include "../utils/language.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
@@ -13,12 +15,23 @@
 #include <vector>
 
 using namespace std;
+using domain_transition_graph::ValueTransitionLabel;
 
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
+static const int EMPTY_BUCKET = -1;
+/*
+  After PROBATION_LOOKUPS lookups, an associative cache is switched off
+  as soon as less than one in MIN_HIT_RATE_INVERSE lookups has hit.
+*/
+static const int PROBATION_LOOKUPS = 10000;
+static const int MIN_HIT_RATE_INVERSE = 10;
 
-CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size,
+                 int max_associative_cache_size, utils::LogProxy &log)
+    : task_proxy(task_proxy),
+      num_evictions(0),
+      num_disabled_caches(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing heuristic cache... " << flush;
     }
@@ -54,18 +67,61 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProx
                               depends_on[var].end());
     }
 
-    cache.resize(var_count);
-    helpful_transition_cache.resize(var_count);
-
+    VariablesProxy variables = task_proxy.get_variables();
+    variable_caches.resize(var_count);
+    vector<int> associative_vars;
     for (int var = 0; var < var_count; ++var) {
-        int required_cache_size = compute_required_cache_size(
-            var, depends_on[var], max_cache_size);
-        if (required_cache_size != -1) {
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, nullptr);
+        VariableCache &var_cache = variable_caches[var];
+        int num_values = variables[var].get_domain_size();
+        var_cache.num_values = num_values;
+        var_cache.capacity = 0;
+        var_cache.is_associative = false;
+        var_cache.num_entries = 0;
+        var_cache.hand = 0;
+        var_cache.num_lookups = 0;
+        var_cache.num_hits = 0;
+        // Variables with a single value never need the cache.
+        if (num_values == 1)
+            continue;
+
+        /*
+          Each entry stores num_values costs. If the entries for all
+          keys fit into max_cache_size costs, we use a direct table.
+        */
+        int num_keys = num_values;
+        for (int dep_var : depends_on[var]) {
+            int dep_domain = variables[dep_var].get_domain_size();
+            if (!utils::is_product_within_limit(num_keys, dep_domain,
+                                                max_cache_size / num_values)) {
+                num_keys = -1;
+                break;
+            }
+            num_keys *= dep_domain;
+        }
+
+        if (num_keys != -1 &&
+            utils::is_product_within_limit(num_keys, num_values,
+                                           max_cache_size)) {
+            var_cache.capacity = num_keys;
+            var_cache.costs.resize(num_keys * num_values, NOT_COMPUTED);
+            var_cache.helpful_transitions.resize(num_keys * num_values, nullptr);
+        } else {
+            associative_vars.push_back(var);
         }
     }
 
+    /*
+      Share the budget for associative caches evenly among the variables.
+      An entry stores the key and the costs.
+    */
+    for (int var : associative_vars) {
+        VariableCache &var_cache = variable_caches[var];
+        int key_size = 1 + depends_on[var].size();
+        var_cache.capacity = max_associative_cache_size /
+            associative_vars.size() / (key_size + var_cache.num_values);
+        var_cache.is_associative = true;
+    }
+
     if (log.is_at_least_normal()) {
         log << "done!" << endl;
     }
@@ -74,61 +130,250 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProx
 CGCache::~CGCache() {
 }
 
-int CGCache::compute_required_cache_size(
-    int var_id, const vector<int> &depends_on, int max_cache_size) const {
-    /*
-      Compute the size of the cache required for variable with ID "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
-    */
+int CGCache::get_index(int var, const State &state, int from_val) const {
+    int index = from_val;
+    int multiplier = variable_caches[var].num_values;
+    for (int dep_var : depends_on[var]) {
+        index += state[dep_var].get_value() * multiplier;
+        multiplier *= variable_caches[dep_var].num_values;
+    }
+    assert(index < variable_caches[var].capacity);
+    return index;
+}
 
-    VariablesProxy variables = task_proxy.get_variables();
-    int var_domain = variables[var_id].get_domain_size();
-    if (!utils::is_product_within_limit(var_domain, var_domain - 1,
-                                        max_cache_size))
+uint32_t CGCache::compute_key(int var, const State &state, int from_val) {
+    key.clear();
+    key.push_back(from_val);
+    for (int dep_var : depends_on[var])
+        key.push_back(state[dep_var].get_value());
+    utils::HashState hash_state;
+    for (int value : key)
+        hash_state.feed(value);
+    return hash_state.get_hash32();
+}
+
+int CGCache::find_entry(int var, uint32_t hash) const {
+    const VariableCache &var_cache = variable_caches[var];
+    if (var_cache.buckets.empty())
         return -1;
+    int key_size = key.size();
+    size_t mask = var_cache.buckets.size() - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+        int entry = var_cache.buckets[pos];
+        if (entry == EMPTY_BUCKET)
+            return -1;
+        if (var_cache.hashes[entry] == hash &&
+            equal(key.begin(), key.end(),
+                  var_cache.keys.begin() + entry * key_size))
+            return entry;
+    }
+}
 
-    int required_size = var_domain * (var_domain - 1);
+void CGCache::insert_into_buckets(VariableCache &var_cache, int entry) {
+    size_t mask = var_cache.buckets.size() - 1;
+    size_t pos = var_cache.hashes[entry] & mask;
+    while (var_cache.buckets[pos] != EMPTY_BUCKET)
+        pos = (pos + 1) & mask;
+    var_cache.buckets[pos] = entry;
+}
 
-    for (int depend_var_id : depends_on) {
-        int depend_var_domain = variables[depend_var_id].get_domain_size();
+void CGCache::remove_from_buckets(VariableCache &var_cache, int entry) {
+    vector<int> &buckets = var_cache.buckets;
+    size_t mask = buckets.size() - 1;
+    size_t pos = var_cache.hashes[entry] & mask;
+    while (buckets[pos] != entry)
+        pos = (pos + 1) & mask;
 
-        /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
-        */
-        if (cache[depend_var_id].empty())
-            return -1;
+    /*
+      Close the gap by moving later entries of the probe sequence back
+      (backward-shift deletion), so that no tombstones are needed.
+    */
+    size_t next = pos;
+    while (true) {
+        next = (next + 1) & mask;
+        int moved_entry = buckets[next];
+        if (moved_entry == EMPTY_BUCKET)
+            break;
+        size_t home = var_cache.hashes[moved_entry] & mask;
+        // Move the entry unless its home bucket lies cyclically in (pos, next].
+        bool home_in_range = (pos <= next) ?
+            (pos < home && home <= next) :
+            (pos < home || home <= next);
+        if (!home_in_range) {
+            buckets[pos] = moved_entry;
+            pos = next;
+        }
+    }
+    buckets[pos] = EMPTY_BUCKET;
+}
 
-        if (!utils::is_product_within_limit(required_size, depend_var_domain,
-                                            max_cache_size))
-            return -1;
+void CGCache::grow_buckets(VariableCache &var_cache) {
+    size_t new_size = max<size_t>(16, 2 * var_cache.buckets.size());
+    var_cache.buckets.assign(new_size, EMPTY_BUCKET);
+    for (int entry = 0; entry < var_cache.num_entries; ++entry)
+        insert_into_buckets(var_cache, entry);
+}
+
+/*
+  Check that every entry is in the buckets exactly once and can be found
+  by probing from its home bucket.
+*/
+bool CGCache::are_buckets_consistent(const VariableCache &var_cache) const {
+    vector<int> num_occurrences(var_cache.num_entries, 0);
+    for (int entry : var_cache.buckets) {
+        if (entry != EMPTY_BUCKET) {
+            if (entry >= var_cache.num_entries)
+                return false;
+            ++num_occurrences[entry];
+        }
+    }
+    size_t mask = var_cache.buckets.size() - 1;
+    for (int entry = 0; entry < var_cache.num_entries; ++entry) {
+        if (num_occurrences[entry] != 1)
+            return false;
+        size_t pos = var_cache.hashes[entry] & mask;
+        while (var_cache.buckets[pos] != entry) {
+            if (var_cache.buckets[pos] == EMPTY_BUCKET)
+                return false;
+            pos = (pos + 1) & mask;
+        }
+    }
+    return true;
+}
 
-        required_size *= depend_var_domain;
+int CGCache::allocate_entry(VariableCache &var_cache, uint32_t hash) {
+    int entry;
+    bool is_evicted = false;
+    if (var_cache.num_entries < var_cache.capacity) {
+        entry = var_cache.num_entries++;
+        var_cache.keys.resize(var_cache.keys.size() + key.size());
+        var_cache.hashes.push_back(hash);
+        var_cache.costs.resize(var_cache.costs.size() + var_cache.num_values);
+        var_cache.helpful_transitions.resize(
+            var_cache.helpful_transitions.size() + var_cache.num_values);
+        var_cache.referenced.push_back(false);
+    } else {
+        // Clock replacement: give referenced entries a second chance.
+        while (var_cache.referenced[var_cache.hand]) {
+            var_cache.referenced[var_cache.hand] = false;
+            var_cache.hand = (var_cache.hand + 1) % var_cache.capacity;
+        }
+        entry = var_cache.hand;
+        var_cache.hand = (var_cache.hand + 1) % var_cache.capacity;
+        remove_from_buckets(var_cache, entry);
+        ++num_evictions;
+        is_evicted = true;
     }
+    copy(key.begin(), key.end(), var_cache.keys.begin() + entry * key.size());
+    var_cache.hashes[entry] = hash;
+    var_cache.referenced[entry] = false;
 
-    return required_size;
+    /*
+      Keep the load factor of the hash table at most 1/2. Growing the
+      table inserts all entries, including the new one, so the hash of
+      the entry must be set before.
+    */
+    bool grow = 2 * static_cast<size_t>(var_cache.num_entries) >
+        var_cache.buckets.size();
+    if (grow)
+        grow_buckets(var_cache);
+    else
+        insert_into_buckets(var_cache, entry);
+    /*
+      Checking after growing and once per sweep of the hand keeps the
+      amortized cost of the check constant.
+    */
+    assert(!(grow || (is_evicted && var_cache.hand == 0)) ||
+           are_buckets_consistent(var_cache));
+    utils::unused_variable(is_evicted);
+    return entry;
 }
 
-int CGCache::get_index(int var, const State &state,
-                       int from_val, int to_val) const {
+void CGCache::disable_if_ineffective(VariableCache &var_cache) {
+    if (var_cache.num_lookups >= PROBATION_LOOKUPS &&
+        var_cache.num_hits * MIN_HIT_RATE_INVERSE < var_cache.num_lookups) {
+        var_cache.capacity = 0;
+        utils::release_vector_memory(var_cache.keys);
+        utils::release_vector_memory(var_cache.hashes);
+        utils::release_vector_memory(var_cache.costs);
+        utils::release_vector_memory(var_cache.helpful_transitions);
+        utils::release_vector_memory(var_cache.referenced);
+        utils::release_vector_memory(var_cache.buckets);
+        var_cache.num_entries = 0;
+        ++num_disabled_caches;
+    }
+}
+
+bool CGCache::lookup(int var, const State &state, int from_val,
+                     vector<int> &costs,
+                     vector<ValueTransitionLabel *> &helpful_transitions) {
     assert(is_cached(var));
-    assert(from_val != to_val);
-    int index = from_val;
-    int multiplier = task_proxy.get_variables()[var].get_domain_size();
-    for (int dep_var : depends_on[var]) {
-        index += state[dep_var].get_value() * multiplier;
-        multiplier *= task_proxy.get_variables()[dep_var].get_domain_size();
+    VariableCache &var_cache = variable_caches[var];
+    int entry;
+    if (var_cache.is_associative) {
+        uint32_t hash = compute_key(var, state, from_val);
+        entry = find_entry(var, hash);
+        ++var_cache.num_lookups;
+        if (entry == -1) {
+            disable_if_ineffective(var_cache);
+            return false;
+        }
+        ++var_cache.num_hits;
+        var_cache.referenced[entry] = true;
+    } else {
+        entry = get_index(var, state, from_val);
+        if (var_cache.costs[entry * var_cache.num_values] == NOT_COMPUTED)
+            return false;
     }
-    if (to_val > from_val)
-        --to_val;
-    index += to_val * multiplier;
-    assert(utils::in_bounds(index, cache[var]));
-    return index;
+    int num_values = var_cache.num_values;
+    auto costs_begin = var_cache.costs.begin() + entry * num_values;
+    costs.assign(costs_begin, costs_begin + num_values);
+    auto helpful_begin =
+        var_cache.helpful_transitions.begin() + entry * num_values;
+    helpful_transitions.assign(helpful_begin, helpful_begin + num_values);
+    return true;
+}
+
+void CGCache::store(int var, const State &state, int from_val,
+                    const vector<int> &costs,
+                    const vector<ValueTransitionLabel *> &helpful_transitions) {
+    // The cache of the variable may have been switched off by lookup().
+    if (!is_cached(var))
+        return;
+    VariableCache &var_cache = variable_caches[var];
+    assert(static_cast<int>(costs.size()) == var_cache.num_values);
+    assert(helpful_transitions.size() == costs.size());
+    int entry;
+    if (var_cache.is_associative) {
+        uint32_t hash = compute_key(var, state, from_val);
+        entry = find_entry(var, hash);
+        if (entry == -1)
+            entry = allocate_entry(var_cache, hash);
+    } else {
+        entry = get_index(var, state, from_val);
+    }
+    int offset = entry * var_cache.num_values;
+    copy(costs.begin(), costs.end(), var_cache.costs.begin() + offset);
+    copy(helpful_transitions.begin(), helpful_transitions.end(),
+         var_cache.helpful_transitions.begin() + offset);
+}
+
+void CGCache::print_statistics(utils::LogProxy &log) const {
+    if (!log.is_at_least_normal())
+        return;
+    int num_associative = 0;
+    int64_t num_entries = 0;
+    for (const VariableCache &var_cache : variable_caches) {
+        if (var_cache.is_associative) {
+            ++num_associative;
+            num_entries += var_cache.num_entries;
+        }
+    }
+    log << "CG cache variables with associative cache: "
+        << num_associative << endl;
+    log << "CG cache associative entries: " << num_entries << endl;
+    log << "CG cache evictions: " << num_evictions << endl;
+    log << "CG cache associative caches switched off: "
+        << num_disabled_caches << endl;
 }
 }
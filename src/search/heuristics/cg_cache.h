@@ -3,6 +3,7 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace domain_transition_graph {
@@ -14,46 +15,101 @@ class LogProxy;
 }
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs computed by the causal graph heuristic.
+  The cost of changing variable v from one value to another only depends
+  on the values of the ancestors of v in the (reduced) causal graph, so
+  the costs and helpful transitions from a given value of v to all other
+  values are stored together in one entry under the key (start value,
+  ancestor values).
+
+  If the entries for all keys of a variable fit into the cache, they are
+  stored in a table indexed by the mixed-radix encoding of the key.
+  Otherwise, the variable gets a bounded associative cache, and all such
+  variables share the memory for max_associative_cache_size stored
+  values (keys and costs) evenly. Keys are found via an open-addressing
+  hash table, and when the cache is full, entries are replaced following
+  the clock algorithm, i.e., the "hand" sweeps over the entries and
+  evicts the first one that has not been looked up since the hand last
+  passed it. If the ancestors are rarely in the same state twice, an
+  associative cache only costs time and memory, so it is switched off
+  if its hit rate is low after a number of lookups.
+*/
 class CGCache {
+    using ValueTransitionLabel = domain_transition_graph::ValueTransitionLabel;
+
+    struct VariableCache {
+        // Number of values of the variable, i.e., costs per entry.
+        int num_values;
+        // Maximum number of entries (0 if the variable is not cached).
+        int capacity;
+        bool is_associative;
+
+        std::vector<int> costs;
+        std::vector<ValueTransitionLabel *> helpful_transitions;
+
+        // Only used by associative caches.
+        int num_entries;
+        int hand;
+        int64_t num_lookups;
+        int64_t num_hits;
+        std::vector<int> keys;
+        std::vector<std::uint32_t> hashes;
+        std::vector<bool> referenced;
+        // Hash table of entry IDs (-1 if unused).
+        std::vector<int> buckets;
+    };
+
     TaskProxy task_proxy;
-    std::vector<std::vector<int>> cache;
-    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
     std::vector<std::vector<int>> depends_on;
+    std::vector<VariableCache> variable_caches;
+    std::vector<int> key;
+    int64_t num_evictions;
+    int num_disabled_caches;
 
-    int get_index(int var, const State &state, int from_val, int to_val) const;
-    int compute_required_cache_size(
-        int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
+    int get_index(int var, const State &state, int from_val) const;
+    std::uint32_t compute_key(int var, const State &state, int from_val);
+    int find_entry(int var, std::uint32_t hash) const;
+    void insert_into_buckets(VariableCache &var_cache, int entry);
+    void remove_from_buckets(VariableCache &var_cache, int entry);
+    void grow_buckets(VariableCache &var_cache);
+    bool are_buckets_consistent(const VariableCache &var_cache) const;
+    /*
+      Return a new or evicted entry for the current key with the given
+      hash. The entry is initialized with the key and in the hash table.
+    */
+    int allocate_entry(VariableCache &var_cache, std::uint32_t hash);
+    void disable_if_ineffective(VariableCache &var_cache);
 public:
     static const int NOT_COMPUTED = -2;
 
-    CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log);
+    CGCache(const TaskProxy &task_proxy, int max_cache_size,
+            int max_associative_cache_size, utils::LogProxy &log);
     ~CGCache();
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return variable_caches[var].capacity > 0;
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
+    /*
+      Copy the costs and helpful transitions from from_val to all values
+      of var into the given vectors. Return false (and leave the vectors
+      unchanged) if they are not in the cache.
+    */
+    bool lookup(int var, const State &state, int from_val,
+                std::vector<int> &costs,
+                std::vector<ValueTransitionLabel *> &helpful_transitions);
 
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    /*
+      Store the costs and helpful transitions from from_val to all
+      values of var. This may evict another entry of the variable and
+      does nothing if the cache of the variable has been switched off.
+    */
+    void store(int var, const State &state, int from_val,
+               const std::vector<int> &costs,
+               const std::vector<ValueTransitionLabel *> &helpful_transitions);
 
-    domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
-
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    void print_statistics(utils::LogProxy &log) const;
 };
 }
 
@@ -29,8 +29,11 @@ CGHeuristic::CGHeuristic(const Options &opts)
     }
 
     int max_cache_size = opts.get<int>("max_cache_size");
-    if (max_cache_size > 0)
-        cache = utils::make_unique_ptr<CGCache>(task_proxy, max_cache_size, log);
+    if (max_cache_size > 0) {
+        cache = utils::make_unique_ptr<CGCache>(
+            task_proxy, max_cache_size,
+            opts.get<int>("max_associative_cache_size"), log);
+    }
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -44,6 +47,16 @@ CGHeuristic::CGHeuristic(const Options &opts)
 }
 
 CGHeuristic::~CGHeuristic() {
+    if (cache && log.is_at_least_normal()) {
+        int64_t num_lookups = cache_hits + cache_misses;
+        log << "CG cache hits: " << cache_hits << endl;
+        log << "CG cache misses: " << cache_misses << endl;
+        if (num_lookups > 0) {
+            log << "CG cache hit rate: "
+                << 100.0 * cache_hits / num_lookups << "%" << endl;
+        }
+        cache->print_statistics(log);
+    }
 }
 
 bool CGHeuristic::dead_ends_are_reliable() const {
@@ -91,20 +104,19 @@ int CGHeuristic::get_transition_cost(const State &state,
 
     int var_no = dtg->var;
 
-    // Check cache.
-    bool use_the_cache = cache && cache->is_cached(var_no);
-    if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
-            return cached_val;
-        }
-    } else {
-        ++cache_misses;
-    }
-
     ValueNode *start = &dtg->nodes[start_val];
     if (start->distances.empty()) {
+        // Check cache.
+        bool use_the_cache = cache && cache->is_cached(var_no);
+        if (use_the_cache) {
+            if (cache->lookup(var_no, state, start_val, start->distances,
+                              start->helpful_transitions)) {
+                ++cache_hits;
+                return start->distances[goal_val];
+            }
+            ++cache_misses;
+        }
+
         // Initialize data of initial node.
         start->distances.resize(dtg->nodes.size(), numeric_limits<int>::max());
         start->helpful_transitions.resize(dtg->nodes.size(), 0);
@@ -203,20 +215,10 @@ int CGHeuristic::get_transition_cost(const State &state,
                 }
             }
         }
-    }
 
-    if (use_the_cache) {
-        int num_values = start->distances.size();
-        for (int val = 0; val < num_values; ++val) {
-            if (val == start_val)
-                continue;
-            int distance = start->distances[val];
-            ValueTransitionLabel *helpful = start->helpful_transitions[val];
-            // We should have a helpful transition iff distance is infinite.
-            assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+        if (use_the_cache) {
+            cache->store(var_no, state, start_val,
+                         start->distances, start->helpful_transitions);
         }
     }
 
@@ -254,19 +256,17 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     dtg->last_helpful_transition_extraction_time =
         helpful_transition_extraction_counter;
 
-    ValueTransitionLabel *helpful;
-    int cost;
-    // Check cache.
-    if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
-    } else {
-        ValueNode *start_node = &dtg->nodes[from];
-        assert(!start_node->helpful_transitions.empty());
-        helpful = start_node->helpful_transitions[to];
-        cost = start_node->distances[to];
-    }
+    /*
+      The costs from the current value are usually known already, but
+      if the variable was only reached via cached costs of its
+      descendants, they have not been looked up yet.
+    */
+    ValueNode *start_node = &dtg->nodes[from];
+    if (start_node->helpful_transitions.empty())
+        get_transition_cost(state, dtg, from, to);
+    assert(!start_node->helpful_transitions.empty());
+    ValueTransitionLabel *helpful = start_node->helpful_transitions[to];
+    int cost = start_node->distances[to];
 
     OperatorProxy op = helpful->is_axiom ?
         task_proxy.get_axioms()[helpful->op_id] :
@@ -303,7 +303,19 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
 
     parser.add_option<int>(
         "max_cache_size",
-        "maximum number of cached entries per variable (set to 0 to disable cache)",
+        "maximum number of cached transition costs per variable "
+        "(set to 0 to disable cache). A variable is cached if the costs "
+        "for all assignments to the variable and its causal-graph "
+        "ancestors fit.",
+        "1000000",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "max_associative_cache_size",
+        "maximum total number of cached transition costs for the variables "
+        "whose costs do not fit into max_cache_size. These variables cache "
+        "the costs of recently seen assignments in hash tables of bounded "
+        "size, in which entries are replaced with the clock algorithm "
+        "(set to 0 to disable these caches).",
         "1000000",
         Bounds("0", "infinity"));
 
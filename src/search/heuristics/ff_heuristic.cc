@@ -22,7 +22,7 @@ FFHeuristic::FFHeuristic(const Options &opts)
 
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
     const State &state, PropID goal_id) {
-    Proposition *goal = get_proposition(goal_id);
+    PropositionState *goal = get_proposition_state(goal_id);
     if (!goal->marked) { // Only consider each subgoal once.
         goal->marked = true;
         OpID op_id = goal->reached_by;
@@ -32,7 +32,7 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
             for (PropID precond : get_preconditions(op_id)) {
                 mark_preferred_operators_and_relaxed_plan(
                     state, precond);
-                if (get_proposition(precond)->reached_by != NO_OP) {
+                if (get_proposition_state(precond)->reached_by != NO_OP) {
                     is_preferred = false;
                 }
             }
@@ -85,6 +85,8 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
+    additive_heuristic::AdditiveHeuristic::add_incremental_option_to_parser(parser);
+    additive_heuristic::AdditiveHeuristic::add_dead_end_filter_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -12,6 +12,7 @@ using relaxation_heuristic::OpID;
 using relaxation_heuristic::NO_OP;
 
 using relaxation_heuristic::Proposition;
+using relaxation_heuristic::PropositionState;
 using relaxation_heuristic::UnaryOperator;
 
 /*
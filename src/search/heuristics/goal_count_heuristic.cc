@@ -29,6 +29,12 @@ int GoalCountHeuristic::compute_heuristic(const State &ancestor_state) {
     return unsatisfied_goal_count;
 }
 
+bool GoalCountHeuristic::get_relevant_variables(set<int> &variables) const {
+    for (FactProxy goal : task_proxy.get_goals())
+        variables.insert(goal.get_variable().get_id());
+    return true;
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Goal count heuristic", "");
     parser.document_language_support("action costs", "ignored by design");
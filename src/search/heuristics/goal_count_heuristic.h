@@ -9,6 +9,8 @@ protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit GoalCountHeuristic(const options::Options &opts);
+
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
 };
 }
 
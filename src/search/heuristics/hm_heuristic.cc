@@ -4,27 +4,198 @@
 #include "../plugin.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+
+static void append_tuples(const vector<vector<int>> &tuples,
+                          vector<int> &tuple_offsets, vector<int> &facts) {
+    for (const vector<int> &tuple : tuples) {
+        facts.insert(facts.end(), tuple.begin(), tuple.end());
+        tuple_offsets.push_back(facts.size());
+    }
+}
+
+static bool has_distinct_vars(const vector<int> &facts,
+                              const vector<int> &fact_vars) {
+    for (size_t i = 1; i < facts.size(); ++i) {
+        if (fact_vars[facts[i - 1]] == fact_vars[facts[i]])
+            return false;
+    }
+    return true;
+}
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
-      has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      has_cond_effects(task_properties::has_conditional_effects(task_proxy)) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+
+    VariablesProxy variables = task_proxy.get_variables();
+    num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        int domain_size = var.get_domain_size();
+        fact_vars.insert(fact_vars.end(), domain_size, var.get_id());
+        num_facts += domain_size;
+    }
+    fact_offsets.push_back(num_facts);
+
+    /*
+      Compute the binomial coefficients and the table size. Intermediate
+      values are capped at limit + 1 so that they cannot overflow.
+    */
+    const int64_t limit = numeric_limits<int>::max();
+    vector<vector<int64_t>> binomials64(
+        m + 1, vector<int64_t>(num_facts + 1, 0));
+    for (int n = 0; n <= num_facts; ++n)
+        binomials64[0][n] = 1;
+    for (int k = 1; k <= m; ++k) {
+        for (int n = 1; n <= num_facts; ++n) {
+            binomials64[k][n] = min(
+                limit + 1, binomials64[k][n - 1] + binomials64[k - 1][n - 1]);
+        }
+    }
+    int64_t total = 0;
+    size_offsets.assign(m + 2, 0);
+    for (int k = 1; k <= m; ++k) {
+        size_offsets[k] = total;
+        total += binomials64[k][num_facts];
+        if (total > limit) {
+            cerr << "The h^" << m << " table for " << num_facts
+                 << " facts is too large." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+        }
+    }
+    size_offsets[m + 1] = total;
+    num_tuples = total;
+    binomials.resize(m + 1);
+    for (int k = 0; k <= m; ++k)
+        binomials[k].assign(binomials64[k].begin(), binomials64[k].end());
+    if (log.is_at_least_normal()) {
+        log << "h^" << m << " table size: " << num_tuples << endl;
+    }
+
+    precondition_offsets.push_back(0);
+    blocked_var_offsets.push_back(0);
+    target_offsets.push_back(0);
+    target_fact_offsets.push_back(0);
+    pre_subtuple_offsets.push_back(0);
+    pre_subtuple_fact_offsets.push_back(0);
+    for (OperatorProxy op : task_proxy.get_operators())
+        build_operator(op);
+
+    int num_operators = op_costs.size();
+    vector<int> num_precondition_of(num_facts, 0);
+    for (int fact : precondition_facts)
+        ++num_precondition_of[fact];
+    precondition_of_offsets.assign(num_facts + 1, 0);
+    for (int fact = 0; fact < num_facts; ++fact) {
+        precondition_of_offsets[fact + 1] =
+            precondition_of_offsets[fact] + num_precondition_of[fact];
+    }
+    precondition_of.resize(precondition_facts.size());
+    vector<int> next_position(
+        precondition_of_offsets.begin(), precondition_of_offsets.end() - 1);
+    for (OpID op_id = 0; op_id < num_operators; ++op_id) {
+        for (int i = precondition_offsets[op_id];
+             i < precondition_offsets[op_id + 1]; ++i)
+            precondition_of[next_position[precondition_facts[i]]++] = op_id;
+        if (num_precondition_tuples[op_id] == 0)
+            operators_without_preconditions.push_back(op_id);
+    }
+
+    Tuple goal_facts;
+    for (FactProxy goal : task_proxy.get_goals())
+        goal_facts.push_back(get_fact_id(goal));
+    utils::sort_unique(goal_facts);
+    collect_subtuple_indices(goal_facts, m, 0, 0, 0, goal_tuples);
+    is_goal_tuple.resize(num_tuples, false);
+    for (int index : goal_tuples)
+        is_goal_tuple[index] = true;
+
+    hm_table.resize(num_tuples, INF);
+    for (int size = 1; size <= m; ++size) {
+        queues.push_back(
+            utils::make_unique_ptr<priority_queues::AdaptiveQueue<int>>());
+    }
+    queue_fronts.resize(m, make_pair(0, -1));
+    closed.resize(num_tuples, false);
+    var_blocked.resize(variables.size(), false);
+}
+
+
+void HMHeuristic::build_operator(const OperatorProxy &op) {
+    op_costs.push_back(op.get_cost());
+
+    Tuple pre;
+    for (FactProxy fact : op.get_preconditions())
+        pre.push_back(get_fact_id(fact));
+    sort(pre.begin(), pre.end());
+    precondition_facts.insert(precondition_facts.end(), pre.begin(), pre.end());
+    precondition_offsets.push_back(precondition_facts.size());
+
+    // Conditions of conditional effects are ignored.
+    Tuple eff;
+    for (EffectProxy effect : op.get_effects())
+        eff.push_back(get_fact_id(effect.get_fact()));
+    utils::sort_unique(eff);
+
+    vector<int> vars;
+    for (int fact : eff)
+        vars.push_back(fact_vars[fact]);
+    vector<int> effect_vars = vars;
+    for (int fact : pre)
+        vars.push_back(fact_vars[fact]);
+    utils::sort_unique(vars);
+    blocked_vars.insert(blocked_vars.end(), vars.begin(), vars.end());
+    blocked_var_offsets.push_back(blocked_vars.size());
+
+    Tuple effects_and_prevails = eff;
+    for (int fact : pre) {
+        if (find(effect_vars.begin(), effect_vars.end(), fact_vars[fact]) ==
+            effect_vars.end())
+            effects_and_prevails.push_back(fact);
+    }
+    sort(effects_and_prevails.begin(), effects_and_prevails.end());
+    vector<Tuple> targets;
+    for (Tuple &tuple : get_subtuples(effects_and_prevails, m)) {
+        bool has_effect = false;
+        for (int fact : tuple) {
+            if (binary_search(eff.begin(), eff.end(), fact)) {
+                has_effect = true;
+                break;
+            }
+        }
+        if (has_effect && has_distinct_vars(tuple, fact_vars))
+            targets.push_back(move(tuple));
+    }
+    for (const Tuple &tuple : targets)
+        target_indices.push_back(get_tuple_index(tuple.data(), tuple.size()));
+    append_tuples(targets, target_fact_offsets, target_facts);
+    target_offsets.push_back(target_fact_offsets.size() - 1);
+
+    vector<int> pre_tuples;
+    collect_subtuple_indices(pre, m, 0, 0, 0, pre_tuples);
+    num_precondition_tuples.push_back(pre_tuples.size());
+
+    vector<Tuple> pre_subtuples = get_subtuples(pre, m - 1);
+    pre_subtuples.insert(pre_subtuples.begin(), Tuple());
+    append_tuples(pre_subtuples, pre_subtuple_fact_offsets, pre_subtuple_facts);
+    pre_subtuple_offsets.push_back(pre_subtuple_fact_offsets.size() - 1);
 }
 
 
@@ -33,233 +204,427 @@ bool HMHeuristic::dead_ends_are_reliable() const {
 }
 
 
-int HMHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    if (task_properties::is_goal_state(task_proxy, state)) {
-        return 0;
-    } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
+int HMHeuristic::get_tuple_index(const int *facts, int size) const {
+    assert(size >= 1 && size <= m);
+    int rank = 0;
+    for (int i = 0; i < size; ++i) {
+        assert(i == 0 || facts[i - 1] < facts[i]);
+        rank += binomials[i + 1][facts[i]];
+    }
+    return size_offsets[size] + rank;
+}
 
-        int h = eval(goals);
 
-        if (h == numeric_limits<int>::max())
-            return DEAD_END;
-        return h;
+int HMHeuristic::get_merged_tuple_index(
+    const int *facts1, int size1, const int *facts2, int size2) const {
+    int size = size1 + size2;
+    assert(size >= 1 && size <= m);
+    int rank = 0;
+    int i = 0;
+    int j = 0;
+    for (int pos = 1; pos <= size; ++pos) {
+        int fact;
+        if (j == size2 || (i < size1 && facts1[i] < facts2[j]))
+            fact = facts1[i++];
+        else
+            fact = facts2[j++];
+        rank += binomials[pos][fact];
     }
+    return size_offsets[size] + rank;
 }
 
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+void HMHeuristic::get_tuple(int index, Tuple &tuple) const {
+    int size = m;
+    while (index < size_offsets[size])
+        --size;
+    int rank = index - size_offsets[size];
+    tuple.resize(size);
+    for (int k = size; k >= 1; --k) {
+        const vector<int> &column = binomials[k];
+        int fact = upper_bound(column.begin(), column.end(), rank) -
+            column.begin() - 1;
+        tuple[k - 1] = fact;
+        rank -= column[fact];
     }
+    assert(rank == 0);
 }
 
 
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
+void HMHeuristic::collect_subtuples(
+    const Tuple &facts, int max_size, int first, Tuple &current,
+    vector<Tuple> &subtuples) const {
+    for (size_t i = first; i < facts.size(); ++i) {
+        current.push_back(facts[i]);
+        subtuples.push_back(current);
+        if (static_cast<int>(current.size()) < max_size)
+            collect_subtuples(facts, max_size, i + 1, current, subtuples);
+        current.pop_back();
+    }
+}
 
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
 
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
-        }
-    } while (was_updated);
+vector<HMHeuristic::Tuple> HMHeuristic::get_subtuples(
+    const Tuple &facts, int max_size) const {
+    // Return all non-empty subsets with at most max_size facts by size.
+    vector<Tuple> subtuples;
+    Tuple current;
+    collect_subtuples(facts, max_size, 0, current, subtuples);
+    stable_sort(subtuples.begin(), subtuples.end(),
+                [](const Tuple &t1, const Tuple &t2) {
+                    return t1.size() < t2.size();
+                });
+    return subtuples;
 }
 
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
-        }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
+void HMHeuristic::collect_subtuple_indices(
+    const Tuple &facts, int max_size, int first, int size, int rank,
+    vector<int> &indices) const {
+    for (size_t i = first; i < facts.size(); ++i) {
+        int new_rank = rank + binomials[size + 1][facts[i]];
+        indices.push_back(size_offsets[size + 1] + new_rank);
+        if (size + 1 < max_size)
+            collect_subtuple_indices(
+                facts, max_size, i + 1, size + 1, new_rank, indices);
+    }
+}
 
-            sort(pre.begin(), pre.end());
 
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
+int HMHeuristic::get_tuple_size(int index) const {
+    int size = m;
+    while (index < size_offsets[size])
+        --size;
+    return size;
+}
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
-        }
+
+void HMHeuristic::push_open_tuple(int index, int size, int value) {
+    pair<int, int> &front = queue_fronts[size - 1];
+    if (front.second == -1) {
+        front = make_pair(value, index);
+    } else if (value < front.first) {
+        queues[size - 1]->push(front.first, front.second);
+        front = make_pair(value, index);
+    } else {
+        queues[size - 1]->push(value, index);
     }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+int HMHeuristic::pop_open_tuple() {
+    // Among tuples of equal cost, smaller tuples are closed first.
+    int best_size = -1;
+    for (int size = 1; size <= m; ++size) {
+        const pair<int, int> &front = queue_fronts[size - 1];
+        if (front.second != -1 &&
+            (best_size == -1 || front.first < queue_fronts[best_size - 1].first))
+            best_size = size;
     }
-    return max;
+    if (best_size == -1)
+        return -1;
+    pair<int, int> &front = queue_fronts[best_size - 1];
+    int index = front.second;
+    priority_queues::AdaptiveQueue<int> &queue = *queues[best_size - 1];
+    if (queue.empty())
+        front.second = -1;
+    else
+        front = queue.pop();
+    return index;
 }
 
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+void HMHeuristic::clear_open_tuples() {
+    for (int size = 1; size <= m; ++size) {
+        queues[size - 1]->clear();
+        queue_fronts[size - 1].second = -1;
     }
-    return val;
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return numeric_limits<int>::max();
-        }
+void HMHeuristic::update_hm_entry(int index, int size, int value) {
+    if (value < hm_table[index]) {
+        assert(!closed[index]);
+        hm_table[index] = value;
+        push_open_tuple(index, size, value);
     }
-    return 0;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+void HMHeuristic::block_operator_vars(OpID op_id, bool blocked) {
+    for (int i = blocked_var_offsets[op_id];
+         i < blocked_var_offsets[op_id + 1]; ++i)
+        var_blocked[blocked_vars[i]] = blocked;
+}
+
+
+void HMHeuristic::apply_operator(OpID op_id, int cost) {
+    /*
+      All precondition tuples have been reached, and the last of them was
+      closed at the given cost. Rules with non-empty Q can only be
+      completed by a precondition tuple if it has m facts.
+    */
+    int value = cost + op_costs[op_id];
+    for (int i = target_offsets[op_id]; i < target_offsets[op_id + 1]; ++i) {
+        int e_size = target_fact_offsets[i + 1] - target_fact_offsets[i];
+        update_hm_entry(target_indices[i], e_size, value);
+    }
+
+    int num_preconditions =
+        precondition_offsets[op_id + 1] - precondition_offsets[op_id];
+    if (m > 1 && num_preconditions >= m) {
+        required_facts.clear();
+        block_operator_vars(op_id, true);
+        enumerate_extended_rules(op_id, 0, cost);
+        block_operator_vars(op_id, false);
+    }
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+void HMHeuristic::enumerate_extended_rules(
+    OpID op_id, int first_position, int cost) {
+    /*
+      Consider all rules (o, Q) where Q consists of required_facts,
+      extension_facts and further facts from closed_facts, starting at
+      first_position, on variables that are not blocked. Only facts whose
+      singleton tuple is closed can be part of a complete rule.
+    */
+    int q_size = required_facts.size() + extension_facts.size();
+    if (q_size > 0)
+        try_extended_rule(op_id, cost);
+    if (q_size == m - 1)
+        return;
+    int num_closed_facts = closed_facts.size();
+    for (int pos = first_position; pos < num_closed_facts; ++pos) {
+        int fact = closed_facts[pos];
+        int var = fact_vars[fact];
+        if (var_blocked[var])
+            continue;
+        extension_facts.push_back(fact);
+        var_blocked[var] = true;
+        enumerate_extended_rules(op_id, pos + 1, cost);
+        var_blocked[var] = false;
+        extension_facts.pop_back();
     }
-    sort(effects.begin(), effects.end());
-    return effects;
 }
 
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+void HMHeuristic::try_extended_rule(OpID op_id, int cost) {
+    rule_facts = required_facts;
+    rule_facts.insert(
+        rule_facts.end(), extension_facts.begin(), extension_facts.end());
+    sort(rule_facts.begin(), rule_facts.end());
+    int q_size = rule_facts.size();
+
+    /*
+      The tuples of pre(o) are closed. Test that all other input tuples,
+      i.e., those containing facts of Q, are closed as well.
+    */
+    int pre_subtuples_begin = pre_subtuple_offsets[op_id];
+    int pre_subtuples_end = pre_subtuple_offsets[op_id + 1];
+    for (int mask = 1; mask < (1 << q_size); ++mask) {
+        subset_facts.clear();
+        for (int i = 0; i < q_size; ++i) {
+            if (mask & (1 << i))
+                subset_facts.push_back(rule_facts[i]);
+        }
+        int x_size = subset_facts.size();
+        for (int i = pre_subtuples_begin; i < pre_subtuples_end; ++i) {
+            int y_begin = pre_subtuple_fact_offsets[i];
+            int y_size = pre_subtuple_fact_offsets[i + 1] - y_begin;
+            if (x_size + y_size > m)
+                break;
+            int index = get_merged_tuple_index(
+                subset_facts.data(), x_size,
+                pre_subtuple_facts.data() + y_begin, y_size);
+            if (!closed[index])
+                return;
         }
     }
-    return false;
+
+    int value = cost + op_costs[op_id];
+    for (int i = target_offsets[op_id]; i < target_offsets[op_id + 1]; ++i) {
+        int e_begin = target_fact_offsets[i];
+        int e_size = target_fact_offsets[i + 1] - e_begin;
+        if (e_size + q_size > m)
+            break;
+        update_hm_entry(
+            get_merged_tuple_index(target_facts.data() + e_begin, e_size,
+                                   rule_facts.data(), q_size),
+            e_size + q_size, value);
+    }
 }
 
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+void HMHeuristic::trigger_extended_rules(OpID op_id, int cost) {
+    /*
+      Consider the rules (o, Q) for which popped_tuple is an input that
+      contains facts of Q. These facts must lie on variables that o
+      neither requires nor touches. If popped_tuple has fewer than m
+      facts, it can only be the last input of the rule if it contains all
+      of pre(o) + Q.
+    */
+    int pre_begin = precondition_offsets[op_id];
+    int pre_end = precondition_offsets[op_id + 1];
+    int blocked_begin = blocked_var_offsets[op_id];
+    int blocked_end = blocked_var_offsets[op_id + 1];
+    required_facts.clear();
+    for (int fact : popped_tuple) {
+        if (binary_search(precondition_facts.begin() + pre_begin,
+                          precondition_facts.begin() + pre_end, fact))
+            continue;
+        if (binary_search(blocked_vars.begin() + blocked_begin,
+                          blocked_vars.begin() + blocked_end, fact_vars[fact]))
+            return;
+        required_facts.push_back(fact);
+    }
+    int num_required = required_facts.size();
+    if (num_required == 0 || num_required >= m)
+        return;
+    if (static_cast<int>(popped_tuple.size()) < m) {
+        assert(popped_tuple.size() == required_facts.size() + pre_end - pre_begin);
+        extension_facts.clear();
+        try_extended_rule(op_id, cost);
+        return;
+    }
+    block_operator_vars(op_id, true);
+    for (int fact : required_facts)
+        var_blocked[fact_vars[fact]] = true;
+    enumerate_extended_rules(op_id, 0, cost);
+    for (int fact : required_facts)
+        var_blocked[fact_vars[fact]] = false;
+    block_operator_vars(op_id, false);
 }
 
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+void HMHeuristic::close_tuple(int index, int cost) {
+    get_tuple(index, popped_tuple);
+    int size = popped_tuple.size();
+    if (size == 1)
+        closed_facts.push_back(popped_tuple[0]);
+
+    /*
+      Tuples are closed in order of increasing cost and, for equal costs,
+      increasing size. Since h^m values are monotone with respect to set
+      inclusion, all subsets of a tuple are closed before the tuple
+      itself, so the last closed input of a rule (o, Q) is either
+      pre(o) + Q or has m facts.
+
+      We handle the rules with non-empty Q before the precondition tuples,
+      because operators that become applicable below check all their
+      rules anyway. If the tuple has m facts, we visit each applicable
+      operator via the first fact of the tuple that it requires.
+      Otherwise, the preconditions of the operator must be a proper
+      subset of the tuple.
+    */
+    if (m > 1) {
+        for (int i = 0; i < size; ++i) {
+            int fact = popped_tuple[i];
+            for (int j = precondition_of_offsets[fact];
+                 j < precondition_of_offsets[fact + 1]; ++j) {
+                OpID op_id = precondition_of[j];
+                if (unsatisfied_preconditions[op_id] != 0)
+                    continue;
+                auto pre_begin =
+                    precondition_facts.begin() + precondition_offsets[op_id];
+                auto pre_end =
+                    precondition_facts.begin() + precondition_offsets[op_id + 1];
+                if (size < m) {
+                    if (*pre_begin == fact && pre_end - pre_begin < size &&
+                        includes(popped_tuple.begin(), popped_tuple.end(),
+                                 pre_begin, pre_end))
+                        trigger_extended_rules(op_id, cost);
+                } else {
+                    bool visited = false;
+                    for (int k = 0; k < i; ++k) {
+                        if (binary_search(pre_begin, pre_end, popped_tuple[k])) {
+                            visited = true;
+                            break;
+                        }
+                    }
+                    if (!visited)
+                        trigger_extended_rules(op_id, cost);
+                }
             }
         }
+        if (size < m) {
+            for (OpID op_id : operators_without_preconditions)
+                trigger_extended_rules(op_id, cost);
+        }
+    }
+
+    // Rules with Q = {}: count the closed precondition tuples.
+    int first_fact = popped_tuple[0];
+    for (int i = precondition_of_offsets[first_fact];
+         i < precondition_of_offsets[first_fact + 1]; ++i) {
+        OpID op_id = precondition_of[i];
+        if (includes(precondition_facts.begin() + precondition_offsets[op_id],
+                     precondition_facts.begin() + precondition_offsets[op_id + 1],
+                     popped_tuple.begin(), popped_tuple.end())) {
+            assert(unsatisfied_preconditions[op_id] > 0);
+            if (--unsatisfied_preconditions[op_id] == 0)
+                apply_operator(op_id, cost);
+        }
     }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+void HMHeuristic::compute_hm_table(const State &state) {
+    fill(hm_table.begin(), hm_table.end(), INF);
+    fill(closed.begin(), closed.end(), false);
+    clear_open_tuples();
+    unsatisfied_preconditions = num_precondition_tuples;
+    closed_facts.clear();
+
+    state_facts.clear();
+    for (FactProxy fact : state)
+        state_facts.push_back(get_fact_id(fact));
+    state_tuples.clear();
+    collect_subtuple_indices(state_facts, m, 0, 0, 0, state_tuples);
+    for (int index : state_tuples)
+        update_hm_entry(index, get_tuple_size(index), 0);
+    for (OpID op_id : operators_without_preconditions)
+        apply_operator(op_id, 0);
+
+    // Stop as soon as all goal tuples are closed.
+    int num_open_goal_tuples = goal_tuples.size();
+    while (num_open_goal_tuples > 0) {
+        int index = pop_open_tuple();
+        if (index == -1)
+            break;
+        if (closed[index])
+            continue;
+        closed[index] = true;
+        if (is_goal_tuple[index])
+            --num_open_goal_tuples;
+        close_tuple(index, hm_table[index]);
+    }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
-        }
-    }
+int HMHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    compute_hm_table(state);
+    int h = 0;
+    for (int index : goal_tuples)
+        h = max(h, hm_table[index]);
+    if (h == INF)
+        return DEAD_END;
+    return h;
 }
 
 
 void HMHeuristic::dump_table() const {
     if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
+        Tuple tuple;
+        for (int index = 0; index < num_tuples; ++index) {
+            if (hm_table[index] == INF)
+                continue;
+            get_tuple(index, tuple);
+            vector<FactPair> facts;
+            for (int fact : tuple)
+                facts.emplace_back(fact_vars[fact], fact - fact_offsets[fact_vars[fact]]);
+            log << "h(" << facts << ") = " << hm_table[index] << endl;
         }
     }
 }
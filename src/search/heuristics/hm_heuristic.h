@@ -3,10 +3,10 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include "../algorithms/priority_queues.h"
+
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace options {
@@ -17,43 +17,133 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Facts are numbered consecutively (ordered by variable), and an m-tuple,
+  i.e., a set of at most m facts, is represented by its sorted fact IDs.
+  Tuples are mapped to positions of a flat table with the combinatorial
+  number system: the tuple c_1 < ... < c_k gets the index
+  size_offsets[k] + sum_i binom(c_i, i). The table also contains
+  positions for tuples with two facts of the same variable, which are
+  never reached.
+
+  The h^m values of a state are computed like h^max on the Pi^m
+  compilation of the task, but without building the compilation
+  explicitly. For every operator o and every set Q of at most m - 1 facts
+  on variables that o neither requires nor touches, there is a rule that
+  reaches all tuples consisting of at least one effect of o, facts of Q
+  and prevail conditions of o. The rule becomes applicable once all
+  tuples of pre(o) + Q have been reached.
+
+  Tuples are closed in order of increasing cost and, for equal costs,
+  increasing size, and a rule is fired by the last of its input tuples
+  that is closed, which is pre(o) + Q itself or a tuple with m facts.
+  For the Q = {} rules, the number of open precondition tuples is counted
+  per operator, and their target tuple indices are precomputed (the
+  partial-effect table).
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    using Tuple = std::vector<int>;
+    using OpID = int;
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
-
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
-
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
-    void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
+    // Fact IDs are fact_offsets[var] + value; fact_offsets has a sentinel.
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+    int num_facts;
+
+    // binomials[k][n] = n choose k for 0 <= k <= m and 0 <= n <= num_facts.
+    std::vector<std::vector<int>> binomials;
+    // size_offsets[k] = number of non-empty tuples with fewer than k facts.
+    std::vector<int> size_offsets;
+    int num_tuples;
+
+    /*
+      Operators in CSR form. Preconditions are sorted fact IDs; blocked
+      variables are the variables of preconditions and effects, which
+      must not occur in the extension set Q of a rule.
+
+      target_facts lists the sets E = P + R (P a non-empty subset of the
+      effects, R a subset of the prevail conditions) of at most m facts,
+      ordered by size; rule (o, Q) reaches E + Q for all E with
+      |E| + |Q| <= m. target_indices holds the table indices of the sets E
+      themselves. pre_subtuple_facts lists all subsets of the
+      preconditions with at most m - 1 facts (including the empty set),
+      ordered by size.
+    */
+    std::vector<int> op_costs;
+    std::vector<int> num_precondition_tuples;
+    std::vector<int> precondition_offsets;
+    std::vector<int> precondition_facts;
+    std::vector<int> blocked_var_offsets;
+    std::vector<int> blocked_vars;
+    std::vector<int> target_offsets;
+    std::vector<int> target_fact_offsets;
+    std::vector<int> target_facts;
+    std::vector<int> target_indices;
+    std::vector<int> pre_subtuple_offsets;
+    std::vector<int> pre_subtuple_fact_offsets;
+    std::vector<int> pre_subtuple_facts;
+    // precondition_of[fact] are the operators with that precondition.
+    std::vector<int> precondition_of_offsets;
+    std::vector<OpID> precondition_of;
+    std::vector<OpID> operators_without_preconditions;
+
+    std::vector<int> goal_tuples;
+    std::vector<bool> is_goal_tuple;
+
+    // Per-state data, kept here to avoid reallocation.
+    std::vector<int> hm_table;
+    std::vector<bool> closed;
+    std::vector<int> unsatisfied_preconditions;
+    std::vector<int> closed_facts;
+    /*
+      Open tuples are closed by increasing cost and, among tuples of equal
+      cost, by increasing size. Packing both into one key could overflow
+      for large operator costs, so there is one queue per tuple size.
+      The cheapest entry of each queue is kept in queue_fronts (with index
+      -1 if the queue is empty), so that the queues can be compared.
+    */
+    std::vector<std::unique_ptr<priority_queues::AdaptiveQueue<int>>> queues;
+    std::vector<std::pair<int, int>> queue_fronts;
+    std::vector<bool> var_blocked;
+    Tuple popped_tuple;
+    Tuple required_facts;
+    Tuple extension_facts;
+    Tuple rule_facts;
+    Tuple subset_facts;
+    Tuple state_facts;
+    std::vector<int> state_tuples;
+
+    void build_operator(const OperatorProxy &op);
+
+    int get_fact_id(const FactProxy &fact) const {
+        return fact_offsets[fact.get_variable().get_id()] + fact.get_value();
+    }
+    int get_tuple_index(const int *facts, int size) const;
+    int get_merged_tuple_index(const int *facts1, int size1,
+                               const int *facts2, int size2) const;
+    void get_tuple(int index, Tuple &tuple) const;
+    void collect_subtuples(const Tuple &facts, int max_size, int first,
+                           Tuple &current, std::vector<Tuple> &subtuples) const;
+    std::vector<Tuple> get_subtuples(const Tuple &facts, int max_size) const;
+    void collect_subtuple_indices(const Tuple &facts, int max_size, int first,
+                                  int size, int rank,
+                                  std::vector<int> &indices) const;
+
+    int get_tuple_size(int index) const;
+    void push_open_tuple(int index, int size, int value);
+    int pop_open_tuple();
+    void clear_open_tuples();
+    void update_hm_entry(int index, int size, int value);
+    void block_operator_vars(OpID op_id, bool blocked);
+    void apply_operator(OpID op_id, int cost);
+    void enumerate_extended_rules(OpID op_id, int first_position, int cost);
+    void try_extended_rule(OpID op_id, int cost);
+    void trigger_extended_rules(OpID op_id, int cost);
+    void close_tuple(int index, int cost);
+    void compute_hm_table(const State &state);
 
     void dump_table() const;
 
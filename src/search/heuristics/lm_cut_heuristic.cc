@@ -21,9 +21,12 @@ LandmarkCutHeuristic::LandmarkCutHeuristic(const Options &opts)
     if (log.is_at_least_normal()) {
         log << "Initializing landmark cut heuristic..." << endl;
     }
+    if (opts.get<bool>("reuse_cuts"))
+        landmark_generator->enable_cut_reuse();
 }
 
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
+    landmark_generator->print_cut_reuse_statistics(log);
 }
 
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -49,6 +52,18 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes");
     parser.document_property("preferred operators", "no");
 
+    parser.add_option<bool>(
+        "reuse_cuts",
+        "start the computation for each state with those cuts of the "
+        "previously evaluated state that are still landmarks for it. "
+        "All reused landmarks are verified with a single bit-parallel "
+        "relaxed exploration. Consecutively evaluated states are often "
+        "siblings, for which most cuts remain valid, so fewer LM-cut "
+        "iterations are needed. The heuristic stays admissible, but its "
+        "values can differ from those computed without cut reuse (in "
+        "both directions), because LM-cut is sensitive to the order in "
+        "which landmarks are found.",
+        "false");
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -1,6 +1,7 @@
 #include "lm_cut_landmarks.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
 
 #include <algorithm>
 #include <limits>
@@ -9,22 +10,41 @@
 using namespace std;
 
 namespace lm_cut_heuristic {
+/*
+  Fill a CSR offset array from the number of entries per row and return
+  the insertion positions for a subsequent pass that places the entries.
+*/
+static vector<int> compute_offsets(
+    const vector<int> &row_sizes, vector<int> &offsets) {
+    offsets.assign(row_sizes.size() + 1, 0);
+    for (size_t i = 0; i < row_sizes.size(); ++i)
+        offsets[i + 1] = offsets[i] + row_sizes[i];
+    return vector<int>(offsets.begin(), offsets.end() - 1);
+}
+
 // construction and destruction
-LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
+LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy)
+    : reuse_cuts(false),
+      num_reuse_candidates(0),
+      num_reused_cuts(0),
+      num_computed_cuts(0) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
 
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    int num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
     }
+    artificial_precondition = num_facts;
+    artificial_goal = num_facts + 1;
+    num_propositions = num_facts + 2;
 
     // Build relaxed operators for operators and axioms.
+    precondition_offsets.push_back(0);
+    effect_offsets.push_back(0);
     for (OperatorProxy op : task_proxy.get_operators())
         build_relaxed_operator(op);
 
@@ -34,84 +54,90 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
        but only after trying out whether and how much the change to
        unary operators hurts. */
 
-    // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
+    // Build artificial goal operator.
+    vector<PropID> goal_op_pre;
     for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
+        goal_op_pre.push_back(get_prop_id(goal));
     }
-    goal_op_eff.push_back(&artificial_goal);
     /* Use the invalid operator ID -1 so accessing
        the artificial operator will generate an error. */
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
+    add_relaxed_operator(goal_op_pre, {artificial_goal}, -1, 0);
 
     // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
+    vector<int> num_precondition_of(num_propositions, 0);
+    vector<int> num_effect_of(num_propositions, 0);
+    for (PropID prop_id : preconditions)
+        ++num_precondition_of[prop_id];
+    for (PropID prop_id : effects)
+        ++num_effect_of[prop_id];
+    vector<int> next_precondition_of =
+        compute_offsets(num_precondition_of, precondition_of_offsets);
+    vector<int> next_effect_of =
+        compute_offsets(num_effect_of, effect_of_offsets);
+    precondition_of.resize(preconditions.size());
+    effect_of.resize(effects.size());
+    int num_operators = get_num_operators();
+    for (OpID op_id = 0; op_id < num_operators; ++op_id) {
+        for (PropID pre : get_preconditions(op_id))
+            precondition_of[next_precondition_of[pre]++] = op_id;
+        for (PropID effect : get_effects(op_id))
+            effect_of[next_effect_of[effect]++] = op_id;
     }
+
+    relaxed_operators = initial_operators;
+    propositions.resize(num_propositions);
 }
 
 LandmarkCutLandmarks::~LandmarkCutLandmarks() {
 }
 
 void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
+    vector<PropID> op_preconditions;
+    vector<PropID> op_effects;
     for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
+        op_preconditions.push_back(get_prop_id(pre));
     }
     for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
+        op_effects.push_back(get_prop_id(eff.get_fact()));
     }
-    add_relaxed_operator(
-        move(precondition), move(effects), op.get_id(), op.get_cost());
+    add_relaxed_operator(op_preconditions, op_effects, op.get_id(), op.get_cost());
 }
 
 void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
+    const vector<PropID> &op_preconditions, const vector<PropID> &op_effects,
     int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
+    original_op_ids.push_back(op_id);
+    if (op_preconditions.empty()) {
+        preconditions.push_back(artificial_precondition);
+    } else {
+        preconditions.insert(
+            preconditions.end(), op_preconditions.begin(), op_preconditions.end());
+    }
+    precondition_offsets.push_back(preconditions.size());
+    effects.insert(effects.end(), op_effects.begin(), op_effects.end());
+    effect_offsets.push_back(effects.size());
+    int num_preconditions = max<int>(op_preconditions.size(), 1);
+    initial_operators.push_back(
+        {base_cost, num_preconditions, numeric_limits<int>::max(), NO_PROP});
 }
 
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
-    int var_id = fact.get_variable().get_id();
-    int val = fact.get_value();
-    return &propositions[var_id][val];
+PropID LandmarkCutLandmarks::get_prop_id(const FactProxy &fact) const {
+    return fact_offsets[fact.get_variable().get_id()] + fact.get_value();
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
-    }
-
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = 0;
-        op.h_max_supporter_cost = numeric_limits<int>::max();
-    }
+    for (RelaxedProposition &prop : propositions)
+        prop.status = UNREACHED;
 }
 
 void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
-        enqueue_if_necessary(get_proposition(init_fact), 0);
+        enqueue_if_necessary(get_prop_id(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
@@ -119,32 +145,28 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop_id = top_pair.second;
+        int prop_cost = propositions[prop_id].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    enqueue_if_necessary(effect, target_cost);
-                }
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            --relaxed_op.unsatisfied_preconditions;
+            assert(relaxed_op.unsatisfied_preconditions >= 0);
+            if (relaxed_op.unsatisfied_preconditions == 0) {
+                relaxed_op.h_max_supporter = prop_id;
+                relaxed_op.h_max_supporter_cost = prop_cost;
+                enqueue_effects_if_necessary(
+                    op_id, prop_cost + relaxed_op.cost);
             }
         }
     }
 }
 
-void LandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutLandmarks::first_exploration_incremental(vector<OpID> &cut) {
     assert(priority_queue.empty());
     /* We pretend that this queue has had as many pushes already as we
        have propositions to avoid switching from bucket-based to
@@ -152,33 +174,31 @@ void LandmarkCutLandmarks::first_exploration_incremental(
        to heap-based in problems where action costs are at most 1.
     */
     priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *relaxed_op : cut) {
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
-            enqueue_if_necessary(effect, cost);
+    for (OpID op_id : cut) {
+        const RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+        enqueue_effects_if_necessary(
+            op_id, relaxed_op.h_max_supporter_cost + relaxed_op.cost);
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop_id = top_pair.second;
+        int prop_cost = propositions[prop_id].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            if (relaxed_op.h_max_supporter == prop_id) {
+                int old_supp_cost = relaxed_op.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(op_id);
+                    int new_supp_cost = relaxed_op.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
-                            enqueue_if_necessary(effect, target_cost);
+                        enqueue_effects_if_necessary(
+                            op_id, new_supp_cost + relaxed_op.cost);
                     }
                 }
             }
@@ -187,43 +207,42 @@ void LandmarkCutLandmarks::first_exploration_incremental(
 }
 
 void LandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+    const State &state, vector<PropID> &second_exploration_queue,
+    vector<OpID> &cut) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    propositions[artificial_precondition].status = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        PropID init_prop = get_prop_id(init_fact);
+        propositions[init_prop].status = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        PropID prop_id = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
-                        reached_goal_zone = true;
-                        cut.push_back(relaxed_op);
-                        break;
-                    }
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            if (relaxed_operators[op_id].h_max_supporter != prop_id)
+                continue;
+            bool reached_goal_zone = false;
+            for (PropID effect : get_effects(op_id)) {
+                if (propositions[effect].status == GOAL_ZONE) {
+                    assert(relaxed_operators[op_id].cost > 0);
+                    reached_goal_zone = true;
+                    cut.push_back(op_id);
+                    break;
                 }
-                if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
-                            second_exploration_queue.push_back(effect);
-                        }
+            }
+            if (!reached_goal_zone) {
+                for (PropID effect : get_effects(op_id)) {
+                    RelaxedProposition &prop = propositions[effect];
+                    if (prop.status != BEFORE_GOAL_ZONE) {
+                        assert(prop.status == REACHED);
+                        prop.status = BEFORE_GOAL_ZONE;
+                        second_exploration_queue.push_back(effect);
                     }
                 }
             }
@@ -231,16 +250,110 @@ void LandmarkCutLandmarks::second_exploration(
     }
 }
 
-void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
+uint64_t LandmarkCutLandmarks::verify_previous_cuts(
+    const State &state, int num_cuts) {
+    /*
+      Test which of the first num_cuts previous cuts are landmarks for the
+      given state, i.e., whether the artificial goal becomes unreachable
+      if all operators of the cut are removed. The tests for all cuts are
+      done in a single exploration: bit i of reached_lanes says whether
+      the proposition is reachable without the operators of cut i.
+    */
+    assert(num_cuts > 0 && num_cuts <= 64);
+    uint64_t all_lanes = (num_cuts == 64) ?
+        ~uint64_t(0) : (uint64_t(1) << num_cuts) - 1;
+    if (excluded_lanes.empty()) {
+        excluded_lanes.resize(get_num_operators(), 0);
+        reached_lanes.resize(num_propositions, 0);
+    }
+    for (int i = 0; i < num_cuts; ++i) {
+        for (OpID op_id : previous_cuts[i])
+            excluded_lanes[op_id] |= uint64_t(1) << i;
+    }
+
+    fill(reached_lanes.begin(), reached_lanes.end(), 0);
+
+    assert(verification_queue.empty());
+    reached_lanes[artificial_precondition] = all_lanes;
+    verification_queue.push_back(artificial_precondition);
+    for (FactProxy init_fact : state) {
+        PropID init_prop = get_prop_id(init_fact);
+        reached_lanes[init_prop] = all_lanes;
+        verification_queue.push_back(init_prop);
+    }
+
+    while (!verification_queue.empty()) {
+        PropID prop_id = verification_queue.back();
+        verification_queue.pop_back();
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            uint64_t lanes = all_lanes & ~excluded_lanes[op_id];
+            for (PropID pre : get_preconditions(op_id)) {
+                lanes &= reached_lanes[pre];
+                if (!lanes)
+                    break;
+            }
+            if (!lanes)
+                continue;
+            for (PropID effect : get_effects(op_id)) {
+                if (lanes & ~reached_lanes[effect]) {
+                    reached_lanes[effect] |= lanes;
+                    verification_queue.push_back(effect);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < num_cuts; ++i) {
+        for (OpID op_id : previous_cuts[i])
+            excluded_lanes[op_id] = 0;
+    }
+    return all_lanes & ~reached_lanes[artificial_goal];
+}
+
+int LandmarkCutLandmarks::reuse_previous_cuts(const State &state) {
+    /*
+      Reduce the operator costs by the cuts of the previous state that are
+      landmarks for this state. Each reused landmark is assigned the
+      minimum remaining cost of its operators, exactly as in the regular
+      LM-cut loop.
+    */
+    current_cuts.clear();
+    current_cut_costs.clear();
+    int num_cuts = min<int>(previous_cuts.size(), 64);
+    if (num_cuts == 0)
+        return 0;
+    num_reuse_candidates += num_cuts;
+    uint64_t valid_cuts = verify_previous_cuts(state, num_cuts);
+    for (int i = 0; i < num_cuts; ++i) {
+        if (!(valid_cuts & (uint64_t(1) << i)))
+            continue;
+        const vector<OpID> &cut = previous_cuts[i];
+        int cut_cost = numeric_limits<int>::max();
+        for (OpID op_id : cut)
+            cut_cost = min(cut_cost, relaxed_operators[op_id].cost);
+        if (cut_cost == 0)
+            continue;
+        for (OpID op_id : cut)
+            relaxed_operators[op_id].cost -= cut_cost;
+        current_cuts.push_back(cut);
+        current_cut_costs.push_back(cut_cost);
+    }
+    num_reused_cuts += current_cuts.size();
+    return current_cuts.size();
+}
+
+void LandmarkCutLandmarks::mark_goal_plateau(PropID subgoal) {
+    // NOTE: subgoal can be NO_PROP if we got here via recursion through
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal != NO_PROP && propositions[subgoal].status != GOAL_ZONE) {
+        propositions[subgoal].status = GOAL_ZONE;
+        for (OpID achiever_id : get_effect_of(subgoal)) {
+            const RelaxedOperator &achiever = relaxed_operators[achiever_id];
+            if (achiever.cost == 0)
+                mark_goal_plateau(achiever.h_max_supporter);
+        }
     }
 }
 
@@ -249,70 +362,91 @@ void LandmarkCutLandmarks::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (const RelaxedOperator &op : relaxed_operators) {
+    int num_operators = get_num_operators();
+    for (OpID op_id = 0; op_id < num_operators; ++op_id) {
+        const RelaxedOperator &op = relaxed_operators[op_id];
         if (op.unsatisfied_preconditions) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (PropID pre : get_preconditions(op_id)) {
+                if (propositions[pre].status == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op.h_max_supporter);
+            assert(op.h_max_supporter == NO_PROP);
         } else {
-            assert(op.h_max_supporter);
+            assert(op.h_max_supporter != NO_PROP);
             int h_max_cost = op.h_max_supporter_cost;
-            assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            assert(h_max_cost == propositions[op.h_max_supporter].h_max_cost);
+            for (PropID pre_id : get_preconditions(op_id)) {
+                const RelaxedProposition &pre = propositions[pre_id];
+                assert(pre.status != UNREACHED);
+                assert(pre.h_max_cost <= h_max_cost);
             }
         }
     }
 #endif
 }
 
+static void report_landmark(
+    const vector<OpID> &cut, int cut_cost,
+    const vector<int> &original_op_ids,
+    const LandmarkCutLandmarks::CostCallback &cost_callback,
+    const LandmarkCutLandmarks::LandmarkCallback &landmark_callback,
+    LandmarkCutLandmarks::Landmark &landmark) {
+    if (cost_callback) {
+        cost_callback(cut_cost);
+    }
+    if (landmark_callback) {
+        landmark.clear();
+        for (OpID op_id : cut) {
+            landmark.push_back(original_op_ids[op_id]);
+        }
+        landmark_callback(landmark, cut_cost);
+    }
+}
+
 bool LandmarkCutLandmarks::compute_landmarks(
     const State &state, CostCallback cost_callback,
     LandmarkCallback landmark_callback) {
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.cost = op.base_cost;
-    }
+    relaxed_operators = initial_operators;
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
     // measurable speed boost.
-    vector<RelaxedOperator *> cut;
+    vector<OpID> cut;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
+    vector<PropID> second_exploration_queue;
+    int num_reused = reuse_cuts ? reuse_previous_cuts(state) : 0;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    RelaxedProposition &goal = propositions[artificial_goal];
+    if (goal.status == UNREACHED)
         return true;
+    for (int i = 0; i < num_reused; ++i) {
+        report_landmark(current_cuts[i], current_cut_costs[i], original_op_ids,
+                        cost_callback, landmark_callback, landmark);
+    }
 
     int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
+    while (goal.h_max_cost != 0) {
         ++num_iterations;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->cost);
-        for (RelaxedOperator *op : cut)
-            op->cost -= cut_cost;
+        for (OpID op_id : cut)
+            cut_cost = min(cut_cost, relaxed_operators[op_id].cost);
+        for (OpID op_id : cut)
+            relaxed_operators[op_id].cost -= cut_cost;
 
-        if (cost_callback) {
-            cost_callback(cut_cost);
-        }
-        if (landmark_callback) {
-            landmark.clear();
-            for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
-            }
-            landmark_callback(landmark, cut_cost);
+        report_landmark(cut, cut_cost, original_op_ids, cost_callback,
+                        landmark_callback, landmark);
+        if (reuse_cuts) {
+            current_cuts.push_back(cut);
+            current_cut_costs.push_back(cut_cost);
         }
 
         first_exploration_incremental(cut);
@@ -325,15 +459,32 @@ bool LandmarkCutLandmarks::compute_landmarks(
           or something based on total_cost, so that we don't need a per-round
           reinitialization.
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (RelaxedProposition &prop : propositions) {
+            if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
+                prop.status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
+    num_computed_cuts += num_iterations;
+    if (reuse_cuts)
+        previous_cuts.swap(current_cuts);
     return false;
 }
+
+void LandmarkCutLandmarks::enable_cut_reuse() {
+    reuse_cuts = true;
+}
+
+void LandmarkCutLandmarks::print_cut_reuse_statistics(
+    utils::LogProxy &log) const {
+    if (!reuse_cuts || !log.is_at_least_normal())
+        return;
+    int64_t num_landmarks = num_reused_cuts + num_computed_cuts;
+    log << "LM-cut reused " << num_reused_cuts << " of "
+        << num_reuse_candidates << " candidate cuts" << endl;
+    if (num_landmarks > 0) {
+        log << "LM-cut reuse rate: "
+            << 100.0 * num_reused_cuts / num_landmarks
+            << "% of " << num_landmarks << " landmarks" << endl;
+    }
+}
 }
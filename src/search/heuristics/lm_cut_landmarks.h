@@ -6,13 +6,21 @@
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
 
+namespace utils {
+class LogProxy;
+}
+
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
+using PropID = int;
+using OpID = int;
+
+const PropID NO_PROP = -1;
 
 enum PropositionStatus {
     UNREACHED = 0,
@@ -21,64 +29,148 @@ enum PropositionStatus {
     BEFORE_GOAL_ZONE = 3
 };
 
+/*
+  Per-state data of relaxed operators and propositions. The static
+  structure of the relaxed task (preconditions, effects and their
+  inverses) is stored separately in CSR form, i.e., as one flat array per
+  relation plus an offset array, so that all entities are referred to
+  by 32-bit indices.
+*/
 struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
-
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
+    PropID h_max_supporter;
 };
 
 struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
     PropositionStatus status;
     int h_max_cost;
 };
 
+// Contiguous range of IDs in one of the CSR arrays.
+class IDSlice {
+    const int *first;
+    const int *last;
+public:
+    IDSlice(const std::vector<int> &ids, const std::vector<int> &offsets,
+            int index)
+        : first(ids.data() + offsets[index]),
+          last(ids.data() + offsets[index + 1]) {
+    }
+
+    const int *begin() const {
+        return first;
+    }
+
+    const int *end() const {
+        return last;
+    }
+
+    int size() const {
+        return last - first;
+    }
+};
+
 class LandmarkCutLandmarks {
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    /*
+      Facts have the IDs fact_offsets[var] + value. They are followed by
+      the artificial precondition of operators without preconditions and
+      the artificial goal, which is the only effect of an artificial goal
+      operator whose preconditions are the goals.
+    */
+    std::vector<int> fact_offsets;
     int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
+    PropID artificial_precondition;
+    PropID artificial_goal;
+
+    // CSR representation of the relaxed task.
+    std::vector<int> original_op_ids;
+    std::vector<int> precondition_offsets;
+    std::vector<PropID> preconditions;
+    std::vector<int> effect_offsets;
+    std::vector<PropID> effects;
+    std::vector<int> precondition_of_offsets;
+    std::vector<OpID> precondition_of;
+    std::vector<int> effect_of_offsets;
+    std::vector<OpID> effect_of;
 
+    /*
+      Operators with their base costs (0 for axioms, 1 for regular
+      operators) and no satisfied preconditions. Copying this array is
+      all that is needed to reset the operators for a new state.
+    */
+    std::vector<RelaxedOperator> initial_operators;
+    std::vector<RelaxedOperator> relaxed_operators;
+    std::vector<RelaxedProposition> propositions;
+    priority_queues::AdaptiveQueue<PropID> priority_queue;
+
+    /*
+      With cut reuse, the cuts of the last computed state are stored and
+      tested as landmarks for the next state before the regular LM-cut
+      loop starts (see verify_previous_cuts()).
+    */
+    bool reuse_cuts;
+    std::vector<std::vector<OpID>> previous_cuts;
+    std::vector<std::vector<OpID>> current_cuts;
+    std::vector<int> current_cut_costs;
+    // Lanes in which an operator is ignored or a proposition is reached.
+    std::vector<uint64_t> excluded_lanes;
+    std::vector<uint64_t> reached_lanes;
+    std::vector<PropID> verification_queue;
+    int64_t num_reuse_candidates;
+    int64_t num_reused_cuts;
+    int64_t num_computed_cuts;
+
+    int get_num_operators() const {
+        return original_op_ids.size();
+    }
+    IDSlice get_preconditions(OpID op_id) const {
+        return IDSlice(preconditions, precondition_offsets, op_id);
+    }
+    IDSlice get_effects(OpID op_id) const {
+        return IDSlice(effects, effect_offsets, op_id);
+    }
+    IDSlice get_precondition_of(PropID prop_id) const {
+        return IDSlice(precondition_of, precondition_of_offsets, prop_id);
+    }
+    IDSlice get_effect_of(PropID prop_id) const {
+        return IDSlice(effect_of, effect_of_offsets, prop_id);
+    }
+    PropID get_prop_id(const FactProxy &fact) const;
     void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
+    void add_relaxed_operator(const std::vector<PropID> &op_preconditions,
+                              const std::vector<PropID> &op_effects,
                               int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<OpID> &cut);
     void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &second_exploration_queue,
-                            std::vector<RelaxedOperator *> &cut);
+                            std::vector<PropID> &second_exploration_queue,
+                            std::vector<OpID> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        RelaxedProposition &prop = propositions[prop_id];
+        if (prop.status == UNREACHED || prop.h_max_cost > cost) {
+            prop.status = REACHED;
+            prop.h_max_cost = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    void enqueue_effects_if_necessary(OpID op_id, int cost) {
+        for (PropID effect : get_effects(op_id))
+            enqueue_if_necessary(effect, cost);
+    }
+
+    inline void update_h_max_supporter(OpID op_id);
+
+    uint64_t verify_previous_cuts(const State &state, int num_cuts);
+    int reuse_previous_cuts(const State &state);
+
+    void mark_goal_plateau(PropID subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
@@ -103,14 +195,30 @@ public:
     */
     bool compute_landmarks(const State &state, CostCallback cost_callback,
                            LandmarkCallback landmark_callback);
+
+    /*
+      Start each computation by reusing those cuts of the previously
+      computed state that are still landmarks for the new state. This
+      pays off if consecutively computed states are similar, e.g. siblings
+      in the search. The reused landmarks form a valid cost partitioning
+      together with the ones computed afterwards, so the result is still
+      admissible, but it can differ from the result without cut reuse.
+    */
+    void enable_cut_reuse();
+    void print_cut_reuse_statistics(utils::LogProxy &log) const;
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(OpID op_id) {
+    RelaxedOperator &op = relaxed_operators[op_id];
+    assert(!op.unsatisfied_preconditions);
+    int supporter_cost = propositions[op.h_max_supporter].h_max_cost;
+    for (PropID pre : get_preconditions(op_id)) {
+        if (propositions[pre].h_max_cost > supporter_cost) {
+            op.h_max_supporter = pre;
+            supporter_cost = propositions[pre].h_max_cost;
+        }
+    }
+    op.h_max_supporter_cost = supporter_cost;
 }
 }
 
@@ -34,17 +34,12 @@ HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
 // heuristic computation
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions)
-        prop.cost = -1;
+    reset_exploration_states();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator &op = unary_operators[op_id];
+        enqueue_if_necessary(op.effect, op.base_cost);
     }
 }
 
@@ -61,29 +56,36 @@ void HSPMaxHeuristic::relaxed_exploration() {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = get_proposition_state(prop_id)->cost;
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
+        const Proposition *prop = get_proposition(prop_id);
         if (prop->is_goal && --unsolved_goals == 0)
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+            OperatorState *op_state = get_operator_state(op_id);
+            --op_state->unsatisfied_preconditions;
+            assert(op_state->unsatisfied_preconditions >= 0);
+            if (op_state->unsatisfied_preconditions == 0) {
+                /*
+                  The preconditions are reached in order of increasing
+                  cost, so the last one determines the h^max cost.
+                */
+                const UnaryOperator &unary_op = unary_operators[op_id];
+                op_state->cost = unary_op.base_cost + prop_cost;
+                enqueue_if_necessary(unary_op.effect, op_state->cost);
+            }
         }
     }
 }
 
 int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    if (is_filtered_dead_end(state))
+        return DEAD_END;
 
     setup_exploration_queue();
     setup_exploration_queue_state(state);
@@ -91,8 +93,7 @@ int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = get_proposition_state(goal_id)->cost;
         if (goal_cost == -1)
             return DEAD_END;
         total_cost = max(total_cost, goal_cost);
@@ -114,6 +115,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "no");
 
+    HSPMaxHeuristic::add_dead_end_filter_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
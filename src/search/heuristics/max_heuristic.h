@@ -11,7 +11,9 @@ namespace max_heuristic {
 using relaxation_heuristic::PropID;
 using relaxation_heuristic::OpID;
 
+using relaxation_heuristic::OperatorState;
 using relaxation_heuristic::Proposition;
+using relaxation_heuristic::PropositionState;
 using relaxation_heuristic::UnaryOperator;
 
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
@@ -23,12 +25,12 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
+        PropositionState *prop_state = get_proposition_state(prop_id);
+        if (prop_state->cost == -1 || prop_state->cost > cost) {
+            prop_state->cost = cost;
             queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_state->cost != -1 && prop_state->cost <= cost);
     }
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
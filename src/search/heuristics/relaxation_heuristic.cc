@@ -1,13 +1,17 @@
 #include "relaxation_heuristic.h"
 
+#include "../option_parser.h"
+
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <numeric>
 #include <unordered_map>
 #include <vector>
 
@@ -15,11 +19,15 @@ using namespace std;
 
 namespace relaxation_heuristic {
 Proposition::Proposition()
+    : num_precondition_occurences(-1),
+      is_goal(false) {
+}
+
+
+PropositionState::PropositionState()
     : cost(-1),
       reached_by(NO_OP),
-      is_goal(false),
-      marked(false),
-      num_precondition_occurences(-1) {
+      marked(false) {
 }
 
 
@@ -36,7 +44,8 @@ UnaryOperator::UnaryOperator(
 
 // construction and destruction
 RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
-    : Heuristic(opts) {
+    : Heuristic(opts),
+      filter_dead_ends(opts.get<bool>("filter_dead_ends", false)) {
     // Build propositions.
     propositions.resize(task_properties::get_num_facts(task_proxy));
 
@@ -49,6 +58,8 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
         offset += var.get_domain_size();
     }
     assert(offset == static_cast<int>(propositions.size()));
+    fact_prop_ids.resize(propositions.size());
+    iota(fact_prop_ids.begin(), fact_prop_ids.end(), 0);
 
     // Build goal propositions.
     GoalsProxy goals = task_proxy.get_goals();
@@ -74,6 +85,8 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
         log << "time to simplify: " << simplify_timer << endl;
     }
 
+    reorder_for_locality();
+
     // Cross-reference unary operators.
     vector<vector<OpID>> precondition_of_vectors(propositions.size());
 
@@ -90,6 +103,74 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
             precondition_of_pool.append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
+
+    // Set up the per-evaluation data.
+    proposition_states.resize(propositions.size());
+    initial_operator_states.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        initial_operator_states.push_back({op.base_cost, op.num_preconditions});
+        if (op.num_preconditions == 0)
+            operators_without_preconditions.push_back(op_id);
+    }
+    operator_states = initial_operator_states;
+
+    if (filter_dead_ends)
+        create_relaxed_reachability();
+}
+
+void RelaxationHeuristic::create_relaxed_reachability() {
+    if (relaxed_reachability)
+        return;
+    int num_unary_ops = unary_operators.size();
+    vector<vector<PropID>> preconditions;
+    vector<PropID> effects;
+    preconditions.reserve(num_unary_ops);
+    effects.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        preconditions.push_back(get_preconditions_vector(op_id));
+        effects.push_back(unary_operators[op_id].effect);
+    }
+    relaxed_reachability = utils::make_unique_ptr<RelaxedReachability>(
+        propositions.size(), preconditions, effects, goal_propositions);
+    state_propositions.reserve(task_proxy.get_variables().size());
+}
+
+void RelaxationHeuristic::collect_state_propositions(
+    const State &state, vector<PropID> &props) const {
+    props.clear();
+    for (FactProxy fact : state)
+        props.push_back(get_prop_id(fact));
+}
+
+int RelaxationHeuristic::compute_relaxed_goal_layer(const State &state) {
+    assert(relaxed_reachability);
+    collect_state_propositions(state, state_propositions);
+    return relaxed_reachability->compute_goal_layer(state_propositions);
+}
+
+void RelaxationHeuristic::compute_relaxed_goal_layers(
+    const vector<State> &states, vector<int> &layers) {
+    assert(relaxed_reachability);
+    if (batch_state_propositions.size() < states.size())
+        batch_state_propositions.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        collect_state_propositions(
+            convert_ancestor_state(states[i]), batch_state_propositions[i]);
+    }
+    batch_state_propositions.resize(states.size());
+    relaxed_reachability->compute_goal_layers(batch_state_propositions, layers);
+}
+
+void RelaxationHeuristic::add_dead_end_filter_option_to_parser(
+    options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "filter_dead_ends",
+        "test relaxed reachability of the goal with a bitset-based layered "
+        "exploration before computing the heuristic and report dead ends "
+        "without running the full exploration. This pays off if many "
+        "evaluated states are relaxed dead ends.",
+        "false");
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
@@ -97,24 +178,18 @@ bool RelaxationHeuristic::dead_ends_are_reliable() const {
 }
 
 PropID RelaxationHeuristic::get_prop_id(int var, int value) const {
-    return proposition_offsets[var] + value;
+    return fact_prop_ids[proposition_offsets[var] + value];
 }
 
 PropID RelaxationHeuristic::get_prop_id(const FactProxy &fact) const {
     return get_prop_id(fact.get_variable().get_id(), fact.get_value());
 }
 
-const Proposition *RelaxationHeuristic::get_proposition(
-    int var, int value) const {
-    return &propositions[get_prop_id(var, value)];
-}
-
-Proposition *RelaxationHeuristic::get_proposition(int var, int value) {
-    return &propositions[get_prop_id(var, value)];
-}
-
-Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
-    return get_proposition(fact.get_variable().get_id(), fact.get_value());
+void RelaxationHeuristic::reset_exploration_states() {
+    fill(proposition_states.begin(), proposition_states.end(),
+         PropositionState());
+    copy(initial_operator_states.begin(), initial_operator_states.end(),
+         operator_states.begin());
 }
 
 void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
@@ -146,6 +221,98 @@ void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
     }
 }
 
+void RelaxationHeuristic::reorder_for_locality() {
+    /*
+      Renumber propositions and unary operators in the order in which a
+      layered relaxed exploration from the initial state reaches them.
+      States evaluated during search tend to be similar to the initial
+      state, so the explorations then mostly proceed through the arrays
+      from front to back, and operators that become applicable together
+      are stored together. Unreachable propositions and operators are
+      placed at the end in their original order.
+    */
+    int num_props = propositions.size();
+    int num_unary_ops = unary_operators.size();
+
+    vector<vector<OpID>> precondition_of_vectors(num_props);
+    vector<int> unsatisfied_preconditions(num_unary_ops);
+    vector<OpID> op_order;
+    op_order.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        for (PropID precond : get_preconditions(op_id))
+            precondition_of_vectors[precond].push_back(op_id);
+        unsatisfied_preconditions[op_id] = unary_operators[op_id].num_preconditions;
+        if (unsatisfied_preconditions[op_id] == 0)
+            op_order.push_back(op_id);
+    }
+
+    vector<PropID> prop_order;
+    prop_order.reserve(num_props);
+    vector<bool> prop_reached(num_props, false);
+    auto reach = [&](PropID prop_id) {
+            if (!prop_reached[prop_id]) {
+                prop_reached[prop_id] = true;
+                prop_order.push_back(prop_id);
+            }
+        };
+    for (FactProxy fact : task_proxy.get_initial_state())
+        reach(get_prop_id(fact));
+
+    size_t next_prop = 0;
+    size_t next_op = 0;
+    while (true) {
+        for (; next_prop < prop_order.size(); ++next_prop) {
+            for (OpID op_id : precondition_of_vectors[prop_order[next_prop]]) {
+                if (--unsatisfied_preconditions[op_id] == 0)
+                    op_order.push_back(op_id);
+            }
+        }
+        if (next_op == op_order.size())
+            break;
+        for (; next_op < op_order.size(); ++next_op)
+            reach(unary_operators[op_order[next_op]].effect);
+    }
+    for (PropID prop_id = 0; prop_id < num_props; ++prop_id)
+        reach(prop_id);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        if (unsatisfied_preconditions[op_id] > 0)
+            op_order.push_back(op_id);
+    }
+    assert(static_cast<int>(prop_order.size()) == num_props);
+    assert(static_cast<int>(op_order.size()) == num_unary_ops);
+
+    vector<PropID> new_prop_ids(num_props);
+    for (PropID new_id = 0; new_id < num_props; ++new_id)
+        new_prop_ids[prop_order[new_id]] = new_id;
+
+    for (PropID &prop_id : fact_prop_ids)
+        prop_id = new_prop_ids[prop_id];
+
+    propositions.assign(num_props, Proposition());
+    for (PropID &goal : goal_propositions) {
+        goal = new_prop_ids[goal];
+        propositions[goal].is_goal = true;
+    }
+
+    vector<UnaryOperator> reordered_operators;
+    reordered_operators.reserve(num_unary_ops);
+    array_pool::ArrayPool reordered_preconditions_pool;
+    vector<PropID> preconditions;
+    for (OpID op_id : op_order) {
+        const UnaryOperator &op = unary_operators[op_id];
+        preconditions.clear();
+        for (PropID precond : get_preconditions(op_id))
+            preconditions.push_back(new_prop_ids[precond]);
+        sort(preconditions.begin(), preconditions.end());
+        reordered_operators.emplace_back(
+            op.num_preconditions,
+            reordered_preconditions_pool.append(preconditions),
+            new_prop_ids[op.effect], op.operator_no, op.base_cost);
+    }
+    unary_operators = move(reordered_operators);
+    preconditions_pool = move(reordered_preconditions_pool);
+}
+
 void RelaxationHeuristic::simplify() {
     /*
       Remove dominated unary operators, including duplicates.
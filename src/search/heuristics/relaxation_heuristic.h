@@ -2,49 +2,63 @@
 #define HEURISTICS_RELAXATION_HEURISTIC_H
 
 #include "array_pool.h"
+#include "relaxed_reachability.h"
 
 #include "../heuristic.h"
 
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <memory>
 #include <vector>
 
 class FactProxy;
 class OperatorProxy;
 
+namespace options {
+class OptionParser;
+}
+
 namespace relaxation_heuristic {
 struct Proposition;
 struct UnaryOperator;
 
-using PropID = int;
-using OpID = int;
-
 const OpID NO_OP = -1;
 
+/*
+  The data of propositions and unary operators is split into a static part
+  (Proposition, UnaryOperator) that is set up once and a per-evaluation
+  part (PropositionState, OperatorState) that is reset and updated for
+  every evaluated state. Keeping the latter in dense arrays of their own
+  means that resetting and updating them does not pull the static data
+  through the cache.
+*/
 struct Proposition {
     Proposition();
+    /* is_goal is conceptually a bool, but Visual C++ does not support
+       packing ints and bools together in a bitfield. */
+    int num_precondition_occurences : 31;
+    unsigned int is_goal : 1;
+    array_pool::ArrayPoolIndex precondition_of;
+};
+
+static_assert(sizeof(Proposition) == 8, "Proposition has wrong size");
+
+struct PropositionState {
+    PropositionState();
     int cost; // used for h^max cost or h^add cost
     // TODO: Make sure in constructor that reached_by does not overflow.
-    OpID reached_by : 30;
-    /* The following two variables are conceptually bools, but Visual C++ does
-       not support packing ints and bools together in a bitfield. */
-    unsigned int is_goal : 1;
+    OpID reached_by : 31;
     unsigned int marked : 1; // used for preferred operators of h^add and h^FF
-    int num_precondition_occurences;
-    array_pool::ArrayPoolIndex precondition_of;
 };
 
-static_assert(sizeof(Proposition) == 16, "Proposition has wrong size");
+static_assert(sizeof(PropositionState) == 8, "PropositionState has wrong size");
 
 struct UnaryOperator {
     UnaryOperator(int num_preconditions,
                   array_pool::ArrayPoolIndex preconditions,
                   PropID effect,
                   int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    int unsatisfied_preconditions;
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,18 +66,46 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
+static_assert(sizeof(UnaryOperator) == 20, "UnaryOperator has wrong size");
+
+struct OperatorState {
+    int cost; // Used for h^max cost or h^add cost;
+              // includes operator cost (base_cost)
+    int unsatisfied_preconditions;
+};
+
+static_assert(sizeof(OperatorState) == 8, "OperatorState has wrong size");
 
 class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op);
     void simplify();
+    void reorder_for_locality();
 
-    // proposition_offsets[var_no]: first PropID related to variable var_no
-    std::vector<PropID> proposition_offsets;
+    /*
+      Propositions are numbered by reorder_for_locality(). The fact with
+      value val of variable var is proposition
+      fact_prop_ids[proposition_offsets[var] + val].
+    */
+    std::vector<int> proposition_offsets;
+    std::vector<PropID> fact_prop_ids;
+
+    std::unique_ptr<RelaxedReachability> relaxed_reachability;
+    std::vector<PropID> state_propositions;
+    std::vector<std::vector<PropID>> batch_state_propositions;
+
+    void collect_state_propositions(
+        const State &state, std::vector<PropID> &props) const;
+    bool filter_dead_ends;
+    // Operator states at the start of each exploration.
+    std::vector<OperatorState> initial_operator_states;
 protected:
     std::vector<UnaryOperator> unary_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
+    std::vector<OpID> operators_without_preconditions;
+
+    std::vector<OperatorState> operator_states;
+    std::vector<PropositionState> proposition_states;
 
     array_pool::ArrayPool preconditions_pool;
     array_pool::ArrayPool precondition_of_pool;
@@ -105,13 +147,49 @@ protected:
     UnaryOperator *get_operator(OpID op_id) {
         return &unary_operators[op_id];
     }
+    PropositionState *get_proposition_state(PropID prop_id) {
+        return &proposition_states[prop_id];
+    }
+    const PropositionState *get_proposition_state(PropID prop_id) const {
+        return &proposition_states[prop_id];
+    }
+    OperatorState *get_operator_state(OpID op_id) {
+        return &operator_states[op_id];
+    }
 
-    const Proposition *get_proposition(int var, int value) const;
-    Proposition *get_proposition(int var, int value);
-    Proposition *get_proposition(const FactProxy &fact);
+    /*
+      Reset all proposition states to "unreached" and all operator states
+      to their base cost with no satisfied preconditions.
+    */
+    void reset_exploration_states();
+
+    /*
+      The bitset-based reachability analysis is built on demand; subclasses
+      that want to use compute_relaxed_goal_layer() directly must call
+      create_relaxed_reachability() in their constructor.
+    */
+    void create_relaxed_reachability();
+    int compute_relaxed_goal_layer(const State &state);
+    // Bit-sliced variant of compute_relaxed_goal_layer for many states.
+    void compute_relaxed_goal_layers(
+        const std::vector<State> &states, std::vector<int> &layers);
+
+    /*
+      Return true if the "filter_dead_ends" option is set and the goal is
+      unreachable from the given state in the delete relaxation. Subclasses
+      call this before their own exploration to skip it for dead ends.
+    */
+    bool is_filtered_dead_end(const State &state) {
+        return filter_dead_ends &&
+               compute_relaxed_goal_layer(state) ==
+               RelaxedReachability::UNREACHABLE;
+    }
 public:
     explicit RelaxationHeuristic(const options::Options &options);
 
+    static void add_dead_end_filter_option_to_parser(
+        options::OptionParser &parser);
+
     virtual bool dead_ends_are_reliable() const override;
 };
 }
@@ -0,0 +1,193 @@
+#include "relaxed_reachability.h"
+
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace relaxation_heuristic {
+RelaxedReachability::RelaxedReachability(
+    int num_propositions,
+    const vector<vector<PropID>> &preconditions,
+    const vector<PropID> &effects,
+    const vector<PropID> &goals)
+    : num_words((num_propositions + 63) / 64) {
+    assert(preconditions.size() == effects.size());
+    int num_ops = effects.size();
+
+    op_offsets.reserve(num_ops);
+    op_precondition_offsets.reserve(num_ops + 1);
+    op_precondition_offsets.push_back(0);
+    vector<int> num_precondition_occurrences(num_propositions, 0);
+    for (OpID op_id = 0; op_id < num_ops; ++op_id) {
+        const vector<PropID> &pre = preconditions[op_id];
+        assert(utils::is_sorted_unique(pre));
+        if (pre.empty())
+            effects_without_preconditions.push_back(effects[op_id]);
+        for (PropID prop_id : pre)
+            ++num_precondition_occurrences[prop_id];
+        vector<WordMask> masks = compute_masks(pre);
+        op_offsets.push_back(op_records.size());
+        op_records.push_back({effects[op_id], masks.size()});
+        op_records.insert(op_records.end(), masks.begin(), masks.end());
+        op_preconditions.insert(op_preconditions.end(), pre.begin(), pre.end());
+        op_precondition_offsets.push_back(op_preconditions.size());
+    }
+
+    precondition_of_offsets.resize(num_propositions + 1, 0);
+    for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
+        precondition_of_offsets[prop_id + 1] =
+            precondition_of_offsets[prop_id] +
+            num_precondition_occurrences[prop_id];
+    }
+    precondition_of.resize(precondition_of_offsets.back());
+    vector<int> next_position(
+        precondition_of_offsets.begin(), precondition_of_offsets.end() - 1);
+    for (OpID op_id = 0; op_id < num_ops; ++op_id) {
+        for (PropID prop_id : preconditions[op_id])
+            precondition_of[next_position[prop_id]++] = op_id;
+    }
+
+    goal_propositions = goals;
+    utils::sort_unique(goal_propositions);
+    goal_masks = compute_masks(goal_propositions);
+
+    reached.resize(num_words, 0);
+    next_layer.resize(num_words, 0);
+    lanes.resize(num_propositions, 0);
+    next_lanes.resize(num_propositions, 0);
+}
+
+vector<RelaxedReachability::WordMask> RelaxedReachability::compute_masks(
+    const vector<PropID> &sorted_props) {
+    vector<WordMask> masks;
+    for (PropID prop_id : sorted_props) {
+        int word = prop_id >> 6;
+        uint64_t bit = uint64_t(1) << (prop_id & 63);
+        if (masks.empty() || masks.back().word != word)
+            masks.push_back({word, bit});
+        else
+            masks.back().bits |= bit;
+    }
+    return masks;
+}
+
+int RelaxedReachability::compute_goal_layer(
+    const vector<PropID> &state_propositions) {
+    fill(reached.begin(), reached.end(), 0);
+    frontier.clear();
+    for (PropID prop_id : state_propositions) {
+        if (!test_bit(reached, prop_id)) {
+            set_bit(reached, prop_id);
+            frontier.push_back(prop_id);
+        }
+    }
+
+    const WordMask *records = op_records.data();
+    int layer = 0;
+    while (!goals_reached()) {
+        assert(next_frontier.empty());
+        if (layer == 0) {
+            for (PropID effect : effects_without_preconditions)
+                add_to_next_layer(effect);
+        }
+        for (PropID prop_id : frontier) {
+            for (int i = precondition_of_offsets[prop_id];
+                 i < precondition_of_offsets[prop_id + 1]; ++i) {
+                const WordMask *op = records + op_offsets[precondition_of[i]];
+                const WordMask *masks = op + 1;
+                if (is_satisfied(masks, masks + op->bits))
+                    add_to_next_layer(op->word);
+            }
+        }
+        if (next_frontier.empty())
+            return UNREACHABLE;
+        for (PropID prop_id : next_frontier) {
+            set_bit(reached, prop_id);
+            next_layer[prop_id >> 6] = 0;
+        }
+        frontier.swap(next_frontier);
+        next_frontier.clear();
+        ++layer;
+    }
+    return layer;
+}
+
+void RelaxedReachability::compute_goal_layers_for_slice(
+    const vector<vector<PropID>> &states, int begin, int end,
+    vector<int> &layers) {
+    int num_lanes = end - begin;
+    assert(num_lanes > 0 && num_lanes <= MAX_SLICE_SIZE);
+    uint64_t all_lanes = (num_lanes == MAX_SLICE_SIZE) ?
+        ~uint64_t(0) : (uint64_t(1) << num_lanes) - 1;
+
+    fill(lanes.begin(), lanes.end(), 0);
+    frontier.clear();
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        layers[begin + lane] = UNREACHABLE;
+        for (PropID prop_id : states[begin + lane]) {
+            if (!lanes[prop_id])
+                frontier.push_back(prop_id);
+            lanes[prop_id] |= uint64_t(1) << lane;
+        }
+    }
+
+    const WordMask *records = op_records.data();
+    uint64_t active_lanes = all_lanes;
+    int layer = 0;
+    while (true) {
+        uint64_t goal_lanes = active_lanes;
+        for (PropID goal : goal_propositions)
+            goal_lanes &= lanes[goal];
+        for (int lane = 0; lane < num_lanes; ++lane) {
+            if (goal_lanes & (uint64_t(1) << lane))
+                layers[begin + lane] = layer;
+        }
+        active_lanes &= ~goal_lanes;
+        if (!active_lanes)
+            break;
+
+        assert(next_frontier.empty());
+        if (layer == 0) {
+            for (PropID effect : effects_without_preconditions)
+                add_lanes_to_next_layer(effect, active_lanes & ~lanes[effect]);
+        }
+        for (PropID prop_id : frontier) {
+            for (int i = precondition_of_offsets[prop_id];
+                 i < precondition_of_offsets[prop_id + 1]; ++i) {
+                OpID op_id = precondition_of[i];
+                PropID effect = records[op_offsets[op_id]].word;
+                uint64_t applicable = active_lanes & ~lanes[effect];
+                for (int j = op_precondition_offsets[op_id];
+                     applicable && j < op_precondition_offsets[op_id + 1];
+                     ++j) {
+                    applicable &= lanes[op_preconditions[j]];
+                }
+                add_lanes_to_next_layer(effect, applicable);
+            }
+        }
+        if (next_frontier.empty())
+            break;
+        for (PropID prop_id : next_frontier) {
+            lanes[prop_id] |= next_lanes[prop_id];
+            next_lanes[prop_id] = 0;
+        }
+        frontier.swap(next_frontier);
+        next_frontier.clear();
+        ++layer;
+    }
+    next_frontier.clear();
+}
+
+void RelaxedReachability::compute_goal_layers(
+    const vector<vector<PropID>> &states, vector<int> &layers) {
+    int num_states = states.size();
+    layers.resize(num_states);
+    for (int begin = 0; begin < num_states; begin += MAX_SLICE_SIZE) {
+        int end = min(begin + MAX_SLICE_SIZE, num_states);
+        compute_goal_layers_for_slice(states, begin, end, layers);
+    }
+}
+}
@@ -0,0 +1,155 @@
+#ifndef HEURISTICS_RELAXED_REACHABILITY_H
+#define HEURISTICS_RELAXED_REACHABILITY_H
+
+#include <cstdint>
+#include <vector>
+
+namespace relaxation_heuristic {
+using PropID = int;
+using OpID = int;
+
+/*
+  Layered relaxed reachability analysis on bitsets.
+
+  The set of reached propositions is stored as a plain array of 64-bit
+  words, and the preconditions of each unary operator (and the goal) are
+  precompiled into (word index, bit mask) pairs. Testing whether an
+  operator is applicable then takes one AND and compare per word spanned
+  by its preconditions instead of one counter update per precondition.
+  Since the preconditions of an operator are sorted and propositions of
+  the same variable are numbered consecutively, most operators only
+  need a handful of words.
+
+  The exploration proceeds in layers: layer 0 contains the propositions
+  of the state, and layer i + 1 additionally contains the effects of all
+  operators applicable in layer i. Only operators that have a
+  precondition in the previous layer's frontier are tested again, so
+  each layer is processed in time proportional to the operators touched
+  by newly reached propositions. An operator that is tested several
+  times in the same layer simply adds its effect once; no per-operator
+  counters exist that would have to be reset between calls, which makes
+  the kernel cheap enough to run in front of the more expensive
+  relaxation heuristics.
+
+  The number of layers needed to reach all goals equals h^max under unit
+  operator costs. If the exploration reaches a fixpoint before all goals
+  are reached, the state is a dead end in the delete relaxation.
+
+  Since the exploration is a monotone fixpoint computation, it can also
+  be run for up to 64 states at once: in the bit-sliced mode used by
+  compute_goal_layers(), each proposition is associated with a 64-bit
+  word whose bit i says whether the proposition is reached for the i-th
+  state, and applying an operator ANDs the words of its preconditions.
+  States whose goals are reached drop out of the computation.
+*/
+class RelaxedReachability {
+    struct WordMask {
+        int word;
+        uint64_t bits;
+    };
+
+    int num_words;
+
+    /*
+      Unary operators are stored back to back in op_records, starting at
+      op_offsets[op_id]. The first record of an operator stores its effect
+      in "word" and the number of precondition masks in "bits"; the masks
+      themselves follow directly, so testing and firing an operator
+      touches a single contiguous block of memory.
+    */
+    std::vector<int> op_offsets;
+    std::vector<WordMask> op_records;
+    std::vector<int> precondition_of_offsets;
+    std::vector<OpID> precondition_of;
+    std::vector<PropID> effects_without_preconditions;
+
+    // The bit-sliced mode needs the preconditions as individual propositions.
+    std::vector<int> op_precondition_offsets;
+    std::vector<PropID> op_preconditions;
+
+    std::vector<WordMask> goal_masks;
+    std::vector<PropID> goal_propositions;
+
+    // Per-call data, kept here to avoid reallocation.
+    std::vector<uint64_t> reached;
+    std::vector<uint64_t> next_layer;
+    std::vector<PropID> frontier;
+    std::vector<PropID> next_frontier;
+    std::vector<uint64_t> lanes;
+    std::vector<uint64_t> next_lanes;
+
+    static std::vector<WordMask> compute_masks(
+        const std::vector<PropID> &sorted_props);
+
+    static bool test_bit(const std::vector<uint64_t> &words, int index) {
+        return words[index >> 6] & (uint64_t(1) << (index & 63));
+    }
+
+    static void set_bit(std::vector<uint64_t> &words, int index) {
+        words[index >> 6] |= uint64_t(1) << (index & 63);
+    }
+
+    bool is_satisfied(const WordMask *begin, const WordMask *end) const {
+        for (const WordMask *mask = begin; mask != end; ++mask) {
+            if ((reached[mask->word] & mask->bits) != mask->bits)
+                return false;
+        }
+        return true;
+    }
+
+    bool goals_reached() const {
+        return is_satisfied(goal_masks.data(),
+                            goal_masks.data() + goal_masks.size());
+    }
+
+    void add_to_next_layer(PropID prop_id) {
+        if (!test_bit(reached, prop_id) && !test_bit(next_layer, prop_id)) {
+            set_bit(next_layer, prop_id);
+            next_frontier.push_back(prop_id);
+        }
+    }
+
+    void add_lanes_to_next_layer(PropID prop_id, uint64_t new_lanes) {
+        if (new_lanes) {
+            if (!next_lanes[prop_id])
+                next_frontier.push_back(prop_id);
+            next_lanes[prop_id] |= new_lanes;
+        }
+    }
+
+    void compute_goal_layers_for_slice(
+        const std::vector<std::vector<PropID>> &states,
+        int begin, int end, std::vector<int> &layers);
+public:
+    static const int MAX_SLICE_SIZE = 64;
+
+    static const int UNREACHABLE = -1;
+
+    /*
+      preconditions[op_id] must be sorted and duplicate-free; effects[op_id]
+      is the single effect of unary operator op_id.
+    */
+    RelaxedReachability(
+        int num_propositions,
+        const std::vector<std::vector<PropID>> &preconditions,
+        const std::vector<PropID> &effects,
+        const std::vector<PropID> &goals);
+
+    /*
+      Return the number of layers needed to reach all goals from the given
+      propositions, or UNREACHABLE if some goal cannot be reached.
+    */
+    int compute_goal_layer(const std::vector<PropID> &state_propositions);
+
+    /*
+      Compute compute_goal_layer() for all given states, processing them
+      in slices of MAX_SLICE_SIZE states. The result for states[i] is
+      stored in layers[i].
+    */
+    void compute_goal_layers(
+        const std::vector<std::vector<PropID>> &states,
+        std::vector<int> &layers);
+};
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "relaxed_reachability_heuristic.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace relaxed_reachability_heuristic {
+RelaxedReachabilityHeuristic::RelaxedReachabilityHeuristic(const Options &opts)
+    : RelaxationHeuristic(opts),
+      batch_registry(nullptr) {
+    if (log.is_at_least_normal()) {
+        log << "Initializing relaxed reachability heuristic..." << endl;
+    }
+    create_relaxed_reachability();
+}
+
+void RelaxedReachabilityHeuristic::precompute_estimates(
+    const vector<State> &states) {
+    batch_values.clear();
+    if (states.empty())
+        return;
+    batch_registry = states.front().get_registry();
+    compute_relaxed_goal_layers(states, batch_layers);
+    for (size_t i = 0; i < states.size(); ++i) {
+        assert(states[i].get_registry() == batch_registry);
+        batch_values.emplace_back(states[i].get_id(), batch_layers[i]);
+    }
+    sort(batch_values.begin(), batch_values.end());
+}
+
+int RelaxedReachabilityHeuristic::compute_heuristic(const State &ancestor_state) {
+    int layer = relaxation_heuristic::RelaxedReachability::UNREACHABLE;
+    auto it = batch_values.end();
+    if (ancestor_state.get_registry() == batch_registry) {
+        it = lower_bound(
+            batch_values.begin(), batch_values.end(), ancestor_state.get_id(),
+            [](const pair<StateID, int> &entry, StateID id) {
+                return entry.first < id;
+            });
+    }
+    if (it != batch_values.end() && it->first == ancestor_state.get_id()) {
+        layer = it->second;
+    } else {
+        State state = convert_ancestor_state(ancestor_state);
+        layer = compute_relaxed_goal_layer(state);
+    }
+    if (layer == relaxation_heuristic::RelaxedReachability::UNREACHABLE)
+        return DEAD_END;
+    return layer;
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Relaxed reachability heuristic",
+        "Computes the number of layers of a relaxed planning graph needed "
+        "to reach the goal, i.e., h^max under unit operator costs. The "
+        "exploration works on bitsets of reached facts and is considerably "
+        "cheaper than the priority-queue based h^max computation. "
+        "Its main use is fast dead-end detection.\n\n"
+        "If the search engine evaluates states in batches (see the "
+        "expansion_batch_size option of eager_greedy), the heuristic "
+        "computes the values of up to 64 states in a single bit-sliced "
+        "exploration, using one bit per state for each fact.");
+    parser.document_language_support("action costs", "ignored by design");
+    parser.document_language_support("conditional effects", "supported");
+    parser.document_language_support(
+        "axioms",
+        "supported (in the sense that the planner won't complain -- "
+        "handling of axioms might be very stupid "
+        "and even render the heuristic unsafe)");
+    parser.document_property("admissible", "yes for tasks without axioms and without zero-cost operators");
+    parser.document_property("consistent", "yes for tasks without axioms and without zero-cost operators");
+    parser.document_property("safe", "yes for tasks without axioms");
+    parser.document_property("preferred operators", "no");
+
+    Heuristic::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<RelaxedReachabilityHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("relaxed_reachability", _parse);
+}
@@ -0,0 +1,31 @@
+#ifndef HEURISTICS_RELAXED_REACHABILITY_HEURISTIC_H
+#define HEURISTICS_RELAXED_REACHABILITY_HEURISTIC_H
+
+#include "relaxation_heuristic.h"
+
+#include <utility>
+#include <vector>
+
+class StateRegistry;
+
+namespace relaxed_reachability_heuristic {
+class RelaxedReachabilityHeuristic
+    : public relaxation_heuristic::RelaxationHeuristic {
+    /*
+      Values computed by the last call to precompute_estimates, sorted by
+      state ID. They are only valid for states of batch_registry.
+    */
+    const StateRegistry *batch_registry;
+    std::vector<std::pair<StateID, int>> batch_values;
+    std::vector<int> batch_layers;
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+public:
+    explicit RelaxedReachabilityHeuristic(const options::Options &opts);
+
+    virtual void precompute_estimates(
+        const std::vector<State> &states) override;
+};
+}
+
+#endif
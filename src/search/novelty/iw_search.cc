@@ -0,0 +1,103 @@
+#include "iw_search.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+
+using namespace std;
+
+namespace novelty {
+IWSearch::IWSearch(const Options &opts)
+    : SearchEngine(opts),
+      fact_indexer(task_proxy),
+      novelty_table(opts.get<int>("width"), fact_indexer.get_num_facts()),
+      num_pruned_states(0) {
+}
+
+int IWSearch::compute_novelty(const State &state) {
+    fact_indexer.compute_fact_ids(state, fact_ids);
+    statistics.inc_evaluated_states();
+    return novelty_table.compute_novelty_and_update(fact_ids);
+}
+
+void IWSearch::initialize() {
+    log << "Conducting IW(" << novelty_table.get_width()
+        << ") search, (real) bound = " << bound << endl;
+    State initial_state = state_registry.get_initial_state();
+    compute_novelty(initial_state);
+    SearchNode node = search_space.get_node(initial_state);
+    node.open_initial();
+    open_list.push_back(initial_state.get_id());
+}
+
+SearchStatus IWSearch::step() {
+    if (open_list.empty()) {
+        log << "Completely explored pruned state space -- no solution!" << endl;
+        return FAILED;
+    }
+    StateID id = open_list.front();
+    open_list.pop_front();
+    State state = state_registry.lookup_state(id);
+    SearchNode node = search_space.get_node(state);
+    node.close();
+    statistics.inc_expanded();
+
+    if (check_goal_and_set_plan(state))
+        return SOLVED;
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (node.get_real_g() + op.get_cost() >= bound)
+            continue;
+
+        State succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (!succ_node.is_new())
+            continue;
+
+        if (compute_novelty(succ_state) > novelty_table.get_width()) {
+            // Pruned states are never reconsidered.
+            succ_node.mark_as_dead_end();
+            ++num_pruned_states;
+            continue;
+        }
+        succ_node.open(node, op, get_adjusted_cost(op));
+        open_list.push_back(succ_state.get_id());
+    }
+    return IN_PROGRESS;
+}
+
+void IWSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    search_space.print_statistics();
+    log << "Pruned states: " << num_pruned_states << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "IW(k) search",
+        "Breadth-first search that prunes all generated states whose "
+        "novelty is larger than the given width. See the novelty evaluator "
+        "for a definition of novelty. For best-first width search, use the "
+        "novelty evaluator within eager or lazy search.");
+    parser.add_option<int>(
+        "width",
+        "maximal novelty of states that are not pruned (1 or 2)",
+        "1",
+        Bounds("1", "2"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<IWSearch>(opts);
+}
+
+static Plugin<SearchEngine> _plugin("iw", _parse);
+}
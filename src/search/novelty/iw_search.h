@@ -0,0 +1,42 @@
+#ifndef NOVELTY_IW_SEARCH_H
+#define NOVELTY_IW_SEARCH_H
+
+#include "novelty_table.h"
+
+#include "../search_engine.h"
+
+#include <deque>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace novelty {
+/*
+  IW(k): breadth-first search that prunes every generated state whose
+  novelty (with respect to all previously generated states) is larger
+  than k. The search is incomplete but runs in time exponential only in k.
+*/
+class IWSearch : public SearchEngine {
+    FactIndexer fact_indexer;
+    NoveltyTable novelty_table;
+    std::deque<StateID> open_list;
+    std::vector<int> fact_ids;
+    int num_pruned_states;
+
+    int compute_novelty(const State &state);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit IWSearch(const options::Options &opts);
+    virtual ~IWSearch() override = default;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "novelty_evaluator.h"
+
+#include "../evaluation_context.h"
+#include "../evaluation_result.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../tasks/root_task.h"
+
+using namespace std;
+
+namespace novelty {
+NoveltyEvaluator::NoveltyEvaluator(const options::Options &opts)
+    : Evaluator(opts),
+      width(opts.get<int>("width")),
+      partition_evaluators(
+          opts.get_list<shared_ptr<Evaluator>>("partition")),
+      fact_indexer(TaskProxy(*tasks::g_root_task)) {
+    partition_key.reserve(partition_evaluators.size());
+}
+
+void NoveltyEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : partition_evaluators)
+        evaluator->get_path_dependent_evaluators(evals);
+}
+
+EvaluationResult NoveltyEvaluator::compute_result(
+    EvaluationContext &eval_context) {
+    partition_key.clear();
+    for (const shared_ptr<Evaluator> &evaluator : partition_evaluators) {
+        partition_key.push_back(
+            eval_context.get_evaluator_value_or_infinity(evaluator.get()));
+    }
+    auto it = tables.find(partition_key);
+    if (it == tables.end()) {
+        it = tables.emplace(
+            partition_key,
+            NoveltyTable(width, fact_indexer.get_num_facts())).first;
+    }
+
+    fact_indexer.compute_fact_ids(eval_context.get_state(), fact_ids);
+    EvaluationResult result;
+    result.set_evaluator_value(it->second.compute_novelty_and_update(fact_ids));
+    return result;
+}
+
+static shared_ptr<Evaluator> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Novelty evaluator",
+        "Returns the novelty of the evaluated state, i.e., the size of the "
+        "smallest set of facts that is true in the state and has not been "
+        "true in any previously evaluated state (with the same values of "
+        "the partition evaluators). If no such set with at most 'width' "
+        "facts exists, the evaluator returns width + 1. "
+        "The evaluator is stateful: every evaluation marks the facts of "
+        "the evaluated state as seen.");
+    parser.document_note(
+        "Best-first width search",
+        "The evaluator can be combined with all open lists. For example, "
+        "BFWS(f5) as described by Lipovetzky and Geffner (AAAI 2017) "
+        "breaks ties in the novelty of a state (partitioned by the goal "
+        "count) by the goal count:\n"
+        "```\n--evaluator hgc=goalcount()\n"
+        "--search eager(tiebreaking([novelty(width=2, partition=[hgc]), "
+        "hgc]))\n```\n");
+    parser.add_option<int>(
+        "width",
+        "maximal size of fact tuples considered (1 or 2)",
+        "2",
+        Bounds("1", "2"));
+    parser.add_list_option<shared_ptr<Evaluator>>(
+        "partition",
+        "compute novelty separately for each combination of values of "
+        "these evaluators",
+        "[]");
+    add_evaluator_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<NoveltyEvaluator>(opts);
+}
+
+static Plugin<Evaluator> _plugin("novelty", _parse);
+}
@@ -0,0 +1,40 @@
+#ifndef NOVELTY_NOVELTY_EVALUATOR_H
+#define NOVELTY_NOVELTY_EVALUATOR_H
+
+#include "novelty_table.h"
+
+#include "../evaluator.h"
+
+#include "../utils/hash.h"
+
+#include <memory>
+#include <vector>
+
+namespace novelty {
+/*
+  Novelty evaluator as used in best-first width search (BFWS). Every
+  evaluation marks the facts of the evaluated state as seen, i.e., the
+  evaluator is stateful and evaluating the same state twice usually yields
+  a different value. If partition evaluators are given, there is one
+  novelty table for each combination of their values.
+*/
+class NoveltyEvaluator : public Evaluator {
+    const int width;
+    std::vector<std::shared_ptr<Evaluator>> partition_evaluators;
+    FactIndexer fact_indexer;
+    utils::HashMap<std::vector<int>, NoveltyTable> tables;
+
+    // Buffers reused across evaluations to avoid allocations.
+    std::vector<int> fact_ids;
+    std::vector<int> partition_key;
+public:
+    explicit NoveltyEvaluator(const options::Options &opts);
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override;
+    virtual EvaluationResult compute_result(
+        EvaluationContext &eval_context) override;
+};
+}
+
+#endif
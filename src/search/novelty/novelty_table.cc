@@ -0,0 +1,71 @@
+#include "novelty_table.h"
+
+#include "../task_proxy.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace novelty {
+FactIndexer::FactIndexer(const TaskProxy &task_proxy)
+    : num_facts(0) {
+    VariablesProxy variables = task_proxy.get_variables();
+    var_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        var_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+}
+
+void FactIndexer::compute_fact_ids(
+    const State &state, vector<int> &fact_ids) const {
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    fact_ids.resize(values.size());
+    for (size_t var = 0; var < values.size(); ++var) {
+        fact_ids[var] = var_offsets[var] + values[var];
+    }
+}
+
+
+NoveltyTable::NoveltyTable(int width, int num_facts)
+    : width(width),
+      num_facts(num_facts),
+      seen_facts(num_facts),
+      seen_fact_pairs(width >= 2 ? get_pair_index(0, num_facts) : 0) {
+    assert(width == 1 || width == 2);
+}
+
+int NoveltyTable::compute_novelty_and_update(const vector<int> &fact_ids) {
+    int novelty = width + 1;
+    int num_state_facts = fact_ids.size();
+    for (int i = 0; i < num_state_facts; ++i) {
+        int fact = fact_ids[i];
+        assert(fact < num_facts);
+        if (!seen_facts.test(fact)) {
+            seen_facts.set(fact);
+            novelty = 1;
+        }
+    }
+    if (width >= 2) {
+        for (int i = 1; i < num_state_facts; ++i) {
+            /*
+              The fact IDs are sorted since the offsets of the variables
+              are increasing and each variable has exactly one value.
+            */
+            int larger_fact = fact_ids[i];
+            size_t row_start = get_pair_index(0, larger_fact);
+            for (int j = 0; j < i; ++j) {
+                assert(fact_ids[j] < larger_fact);
+                size_t index = row_start + fact_ids[j];
+                if (!seen_fact_pairs.test(index)) {
+                    seen_fact_pairs.set(index);
+                    if (novelty > 2)
+                        novelty = 2;
+                }
+            }
+        }
+    }
+    return novelty;
+}
+}
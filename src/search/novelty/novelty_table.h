@@ -0,0 +1,67 @@
+#ifndef NOVELTY_NOVELTY_TABLE_H
+#define NOVELTY_NOVELTY_TABLE_H
+
+#include "../algorithms/dynamic_bitset.h"
+
+#include <cstdint>
+#include <vector>
+
+class State;
+class TaskProxy;
+
+namespace novelty {
+/*
+  Maps the facts of a task to consecutive integers: fact (var, value) has
+  the ID var_offset[var] + value. The IDs of the facts of a state are
+  computed in increasing order.
+*/
+class FactIndexer {
+    std::vector<int> var_offsets;
+    int num_facts;
+public:
+    explicit FactIndexer(const TaskProxy &task_proxy);
+
+    void compute_fact_ids(const State &state, std::vector<int> &fact_ids) const;
+
+    int get_num_facts() const {
+        return num_facts;
+    }
+};
+
+/*
+  Bit tables storing which facts (width 1) and which pairs of facts
+  (width 2) have already been seen. The novelty of a state is the size of
+  the smallest tuple of facts that is true in the state and has not been
+  seen before, or width + 1 if no such tuple of size at most width exists.
+
+  For width 2 the pairs are stored in a triangular bit matrix, i.e., the
+  table needs num_facts * (num_facts - 1) / 2 bits. Checking a state with
+  n variables touches n bits for width 1 and n * (n - 1) / 2 bits for
+  width 2.
+*/
+class NoveltyTable {
+    int width;
+    int num_facts;
+    dynamic_bitset::DynamicBitset<uint64_t> seen_facts;
+    dynamic_bitset::DynamicBitset<uint64_t> seen_fact_pairs;
+
+    static std::size_t get_pair_index(int smaller_fact, int larger_fact) {
+        return static_cast<std::size_t>(larger_fact) * (larger_fact - 1) / 2 +
+               smaller_fact;
+    }
+public:
+    NoveltyTable(int width, int num_facts);
+
+    /*
+      Compute the novelty of the state with the given (sorted) fact IDs
+      and mark all its facts and fact pairs as seen.
+    */
+    int compute_novelty_and_update(const std::vector<int> &fact_ids);
+
+    int get_width() const {
+        return width;
+    }
+};
+}
+
+#endif
@@ -5,11 +5,13 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/collections.h"
 #include "../utils/hash.h"
 #include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <set>
@@ -20,23 +22,39 @@
 using namespace std;
 
 namespace pareto_open_list {
+/*
+  The non-dominated keys ("the front") are kept in a set that is sorted
+  lexicographically. Since a key can only be dominated by keys that are
+  lexicographically smaller, dominance tests against the front only
+  have to look at a prefix (or suffix) of the set.
+
+  Every dominated key is attached to exactly one key of the front that
+  dominates it. When a front key is removed, only the keys attached to it
+  can become non-dominated, so we never have to scan all buckets.
+*/
 template<class Entry>
 class ParetoOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
 
     using Bucket = deque<Entry>;
     using KeyType = vector<int>;
-    using BucketMap = utils::HashMap<KeyType, Bucket>;
     using KeySet = set<KeyType>;
 
+    struct KeyInfo {
+        Bucket bucket;
+        // Keys dominated by this key (only used for keys of the front).
+        vector<const KeyType *> dominated_keys;
+    };
+    using BucketMap = utils::HashMap<KeyType, KeyInfo>;
+
     BucketMap buckets;
     KeySet nondominated;
     bool state_uniform_selection;
     vector<shared_ptr<Evaluator>> evaluators;
 
     bool dominates(const KeyType &v1, const KeyType &v2) const;
-    bool is_nondominated(
-        const KeyType &vec, KeySet &domination_candidates) const;
+    const KeyType *find_dominating_key(const KeyType &key) const;
+    void insert_key(const KeyType &key);
     void remove_key(const KeyType &key);
 
 protected:
@@ -82,12 +100,56 @@ bool ParetoOpenList<Entry>::dominates(
 }
 
 template<class Entry>
-bool ParetoOpenList<Entry>::is_nondominated(
-    const KeyType &vec, KeySet &domination_candidates) const {
-    for (const KeyType &candidate : domination_candidates)
-        if (dominates(candidate, vec))
-            return false;
-    return true;
+const vector<int> *ParetoOpenList<Entry>::find_dominating_key(
+    const KeyType &key) const {
+    // Only keys that are lexicographically smaller can dominate key.
+    for (auto it = nondominated.begin();
+         it != nondominated.end() && *it < key; ++it) {
+        if (dominates(*it, key))
+            return &*it;
+    }
+    return nullptr;
+}
+
+template<class Entry>
+void ParetoOpenList<Entry>::insert_key(const KeyType &key) {
+    /*
+      Insert a key that has a non-empty bucket but is neither part of the
+      front nor attached to a key of the front.
+    */
+    const KeyType *dominating_key = find_dominating_key(key);
+    if (dominating_key) {
+        buckets[*dominating_key].dominated_keys.push_back(&key);
+        return;
+    }
+
+    /*
+      Keys of the front that are now dominated by key are moved (together
+      with the keys they dominate) to the list of keys dominated by key.
+      Only lexicographically larger keys can be dominated by key.
+
+      Note: this requires that nondominated is a "normal"
+      set (no hash set) because then iterators are not
+      invalidated by erase(it).
+    */
+    KeyInfo &info = buckets[key];
+    auto it = nondominated.upper_bound(key);
+    while (it != nondominated.end()) {
+        if (dominates(key, *it)) {
+            auto dominated_it = buckets.find(*it);
+            KeyInfo &dominated_info = dominated_it->second;
+            info.dominated_keys.push_back(&dominated_it->first);
+            info.dominated_keys.insert(
+                info.dominated_keys.end(),
+                dominated_info.dominated_keys.begin(),
+                dominated_info.dominated_keys.end());
+            utils::release_vector_memory(dominated_info.dominated_keys);
+            it = nondominated.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    nondominated.insert(key);
 }
 
 template<class Entry>
@@ -98,26 +160,26 @@ void ParetoOpenList<Entry>::remove_key(const KeyType &key) {
       invalid at that point.
     */
     vector<int> copied_key(key);
+    auto bucket_it = buckets.find(copied_key);
+    assert(bucket_it != buckets.end());
+    vector<const KeyType *> candidates =
+        move(bucket_it->second.dominated_keys);
     nondominated.erase(copied_key);
-    buckets.erase(copied_key);
-    KeySet candidates;
-    for (const auto &bucket_pair : buckets) {
-        const KeyType &bucket_key = bucket_pair.first;
-        /*
-          If the estimate vector of the bucket is not already in the
-          set of nondominated estimate vectors and the vector was
-          previously dominated by key and the estimate vector is not
-          dominated by any vector from the set of nondominated
-          vectors, we add it to the candidates.
-        */
-        if (!nondominated.count(bucket_key) &&
-            dominates(copied_key, bucket_key) &&
-            is_nondominated(bucket_key, nondominated))
-            candidates.insert(bucket_key);
-    }
-    for (const KeyType &candidate : candidates)
-        if (is_nondominated(candidate, candidates))
-            nondominated.insert(candidate);
+    buckets.erase(bucket_it);
+
+    /*
+      Only keys previously dominated by key can become nondominated. They
+      cannot dominate any remaining key of the front (otherwise key would
+      have dominated that key as well). Processing them in lexicographic
+      order ensures that a candidate is only added to the front after all
+      candidates that could dominate it have been placed.
+    */
+    sort(candidates.begin(), candidates.end(),
+         [](const KeyType *lhs, const KeyType *rhs) {
+             return *lhs < *rhs;
+         });
+    for (const KeyType *candidate : candidates)
+        insert_key(*candidate);
 }
 
 template<class Entry>
@@ -128,32 +190,13 @@ void ParetoOpenList<Entry>::do_insertion(
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
 
-    Bucket &bucket = buckets[key];
+    auto result = buckets.emplace(move(key), KeyInfo());
+    Bucket &bucket = result.first->second.bucket;
     bool newkey = bucket.empty();
     bucket.push_back(entry);
 
-    if (newkey && is_nondominated(key, nondominated)) {
-        /*
-          Delete previously nondominated keys that are now dominated
-          by key.
-
-          Note: this requires that nondominated is a "normal"
-          set (no hash set) because then iterators are not
-          invalidated by erase(it).
-        */
-        auto it = nondominated.begin();
-        while (it != nondominated.end()) {
-            if (dominates(key, *it)) {
-                auto tmp_it = it;
-                ++it;
-                nondominated.erase(tmp_it);
-            } else {
-                ++it;
-            }
-        }
-        // Insert new key.
-        nondominated.insert(key);
-    }
+    if (newkey)
+        insert_key(result.first->first);
 }
 
 template<class Entry>
@@ -171,7 +214,7 @@ Entry ParetoOpenList<Entry>::remove_min() {
         if (rng->random(seen) < numerator)
             selected = it;
     }
-    Bucket &bucket = buckets[*selected];
+    Bucket &bucket = buckets[*selected].bucket;
     Entry result = bucket.front();
     bucket.pop_front();
     if (bucket.empty())
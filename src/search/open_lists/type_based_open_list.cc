@@ -12,6 +12,8 @@
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
+#include <algorithm>
+#include <cassert>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -19,15 +21,124 @@
 using namespace std;
 
 namespace type_based_open_list {
+/*
+  Storage for the entries of all buckets. A bucket stores its entries in
+  a list of chunks, whose sizes double from 1 up to MAX_CHUNK_SIZE and
+  then stay at MAX_CHUNK_SIZE. The i-th entry of a bucket can therefore
+  be found in constant time, and a bucket with n entries occupies at
+  most max(2n - 1, n + MAX_CHUNK_SIZE - 1) entries, so that the many
+  small buckets of type-based open lists stay small. Chunks of the same
+  size are stored consecutively in a single vector. Chunks that become
+  empty are put on a free list of their size and reused, so that after
+  the initial growth of the pool, inserting and removing entries does
+  not allocate memory.
+*/
+template<class Entry>
+class ChunkedEntryPool {
+public:
+    // The chunks with sizes 1, 2, ..., MAX_CHUNK_SIZE.
+    static const int NUM_GROWING_CHUNKS = 6;
+private:
+    static const int NUM_CHUNK_SIZES = NUM_GROWING_CHUNKS;
+    static const int MAX_CHUNK_SIZE = 1 << (NUM_CHUNK_SIZES - 1);
+    // Number of entries in the chunks with sizes 1, 2, ..., MAX_CHUNK_SIZE.
+    static const int GROWING_CHUNKS_CAPACITY = 2 * MAX_CHUNK_SIZE - 1;
+
+    // Chunks with 2^i entries are stored in entries[i].
+    std::vector<Entry> entries[NUM_CHUNK_SIZES];
+    std::vector<int> free_chunks[NUM_CHUNK_SIZES];
+
+    static int get_size_class(int chunk_index) {
+        return std::min(chunk_index, NUM_CHUNK_SIZES - 1);
+    }
+public:
+    /*
+      Compute the index of the chunk (in the list of chunks of a bucket)
+      and the offset within the chunk of the entry at position pos.
+    */
+    static void locate(int pos, int &chunk_index, int &offset) {
+        if (pos < GROWING_CHUNKS_CAPACITY) {
+            // Chunk k holds the positions [2^k - 1, 2^(k + 1) - 1).
+            chunk_index = 0;
+            while (pos >= (2 << chunk_index) - 1)
+                ++chunk_index;
+            offset = pos - ((1 << chunk_index) - 1);
+        } else {
+            pos -= GROWING_CHUNKS_CAPACITY;
+            chunk_index = NUM_CHUNK_SIZES + pos / MAX_CHUNK_SIZE;
+            offset = pos % MAX_CHUNK_SIZE;
+        }
+    }
+
+    int allocate_chunk(int chunk_index, const Entry &filler) {
+        int size_class = get_size_class(chunk_index);
+        std::vector<int> &free = free_chunks[size_class];
+        if (free.empty()) {
+            std::vector<Entry> &chunks = entries[size_class];
+            int chunk = chunks.size() >> size_class;
+            chunks.resize(chunks.size() + (1 << size_class), filler);
+            return chunk;
+        }
+        int chunk = free.back();
+        free.pop_back();
+        return chunk;
+    }
+
+    void release_chunk(int chunk_index, int chunk) {
+        free_chunks[get_size_class(chunk_index)].push_back(chunk);
+    }
+
+    Entry &get_entry(int chunk_index, int chunk, int offset) {
+        int size_class = get_size_class(chunk_index);
+        assert(offset >= 0 && offset < (1 << size_class));
+        return entries[size_class][(chunk << size_class) + offset];
+    }
+
+    void clear() {
+        for (int size_class = 0; size_class < NUM_CHUNK_SIZES; ++size_class) {
+            entries[size_class].clear();
+            free_chunks[size_class].clear();
+        }
+    }
+};
+
 template<class Entry>
 class TypeBasedOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
     vector<shared_ptr<Evaluator>> evaluators;
 
     using Key = vector<int>;
-    using Bucket = vector<Entry>;
+    using Pool = ChunkedEntryPool<Entry>;
+    /*
+      The growing chunks of a bucket are stored inline, so buckets with
+      at most 63 entries do not allocate memory of their own. Only larger
+      buckets store their further chunks in full_chunks.
+    */
+    struct Bucket {
+        int size = 0;
+        int growing_chunks[Pool::NUM_GROWING_CHUNKS];
+        vector<int> full_chunks;
+    };
     vector<pair<Key, Bucket>> keys_and_buckets;
     utils::HashMap<Key, int> key_to_bucket_index;
+    Pool pool;
+
+    static int &get_chunk(Bucket &bucket, int chunk_index) {
+        if (chunk_index < Pool::NUM_GROWING_CHUNKS)
+            return bucket.growing_chunks[chunk_index];
+        assert(utils::in_bounds(chunk_index - Pool::NUM_GROWING_CHUNKS,
+                                bucket.full_chunks));
+        return bucket.full_chunks[chunk_index - Pool::NUM_GROWING_CHUNKS];
+    }
+    Entry &get_entry(Bucket &bucket, int pos) {
+        assert(pos >= 0 && pos < bucket.size);
+        int chunk_index;
+        int offset;
+        Pool::locate(pos, chunk_index, offset);
+        return pool.get_entry(chunk_index, get_chunk(bucket, chunk_index), offset);
+    }
+    void push_entry(Bucket &bucket, const Entry &entry);
+    Entry swap_and_pop_entry(Bucket &bucket, int pos);
 
 protected:
     virtual void do_insertion(
@@ -46,6 +157,46 @@ public:
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
 };
 
+template<class Entry>
+void TypeBasedOpenList<Entry>::push_entry(Bucket &bucket, const Entry &entry) {
+    int chunk_index;
+    int offset;
+    Pool::locate(bucket.size, chunk_index, offset);
+    // Each chunk is allocated when its first entry is added.
+    if (offset == 0) {
+        int chunk = pool.allocate_chunk(chunk_index, entry);
+        if (chunk_index < Pool::NUM_GROWING_CHUNKS) {
+            bucket.growing_chunks[chunk_index] = chunk;
+        } else {
+            assert(chunk_index - Pool::NUM_GROWING_CHUNKS ==
+                   static_cast<int>(bucket.full_chunks.size()));
+            bucket.full_chunks.push_back(chunk);
+        }
+    }
+    ++bucket.size;
+    get_entry(bucket, bucket.size - 1) = entry;
+}
+
+template<class Entry>
+Entry TypeBasedOpenList<Entry>::swap_and_pop_entry(Bucket &bucket, int pos) {
+    Entry &slot = get_entry(bucket, pos);
+    Entry result = slot;
+    slot = get_entry(bucket, bucket.size - 1);
+    --bucket.size;
+    int chunk_index;
+    int offset;
+    Pool::locate(bucket.size, chunk_index, offset);
+    if (offset == 0) {
+        pool.release_chunk(chunk_index, get_chunk(bucket, chunk_index));
+        if (chunk_index >= Pool::NUM_GROWING_CHUNKS) {
+            assert(chunk_index - Pool::NUM_GROWING_CHUNKS ==
+                   static_cast<int>(bucket.full_chunks.size()) - 1);
+            bucket.full_chunks.pop_back();
+        }
+    }
+    return result;
+}
+
 template<class Entry>
 void TypeBasedOpenList<Entry>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
@@ -59,11 +210,12 @@ void TypeBasedOpenList<Entry>::do_insertion(
     auto it = key_to_bucket_index.find(key);
     if (it == key_to_bucket_index.end()) {
         key_to_bucket_index[key] = keys_and_buckets.size();
-        keys_and_buckets.push_back(make_pair(move(key), Bucket({entry})));
+        keys_and_buckets.emplace_back(move(key), Bucket());
+        push_entry(keys_and_buckets.back().second, entry);
     } else {
         size_t bucket_index = it->second;
         assert(utils::in_bounds(bucket_index, keys_and_buckets));
-        keys_and_buckets[bucket_index].second.push_back(entry);
+        push_entry(keys_and_buckets[bucket_index].second, entry);
     }
 }
 
@@ -79,10 +231,10 @@ Entry TypeBasedOpenList<Entry>::remove_min() {
     auto &key_and_bucket = keys_and_buckets[bucket_id];
     const Key &min_key = key_and_bucket.first;
     Bucket &bucket = key_and_bucket.second;
-    int pos = rng->random(bucket.size());
-    Entry result = utils::swap_and_pop_from_vector(bucket, pos);
+    int pos = rng->random(bucket.size);
+    Entry result = swap_and_pop_entry(bucket, pos);
 
-    if (bucket.empty()) {
+    if (bucket.size == 0) {
         // Swap the empty bucket with the last bucket, then delete it.
         key_to_bucket_index[keys_and_buckets.back().first] = bucket_id;
         key_to_bucket_index.erase(min_key);
@@ -100,6 +252,7 @@ template<class Entry>
 void TypeBasedOpenList<Entry>::clear() {
     keys_and_buckets.clear();
     key_to_bucket_index.clear();
+    pool.clear();
 }
 
 template<class Entry>
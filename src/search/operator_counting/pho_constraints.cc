@@ -9,6 +9,7 @@
 #include "../pdbs/pattern_generator.h"
 
 #include "../utils/markup.h"
+#include "../utils/memory.h"
 
 #include <cassert>
 #include <limits>
@@ -36,6 +37,7 @@ void PhOConstraints::initialize_constraints(
     */
     pattern_generator = nullptr;
     pdbs = pattern_collection_info.get_pdbs();
+    pdb_lookup = utils::make_unique_ptr<pdbs::PDBLookup>(*pdbs);
     TaskProxy task_proxy(*task);
     named_vector::NamedVector<lp::LPConstraint> &constraints = lp.get_constraints();
     constraint_offset = constraints.size();
@@ -53,10 +55,11 @@ void PhOConstraints::initialize_constraints(
 bool PhOConstraints::update_constraints(const State &state,
                                         lp::LPSolver &lp_solver) {
     state.unpack();
-    for (size_t i = 0; i < pdbs->size(); ++i) {
+    const vector<int> &h_values =
+        pdb_lookup->compute_values(state.get_unpacked_values());
+    for (size_t i = 0; i < h_values.size(); ++i) {
         int constraint_id = constraint_offset + i;
-        shared_ptr<pdbs::PatternDatabase> pdb = (*pdbs)[i];
-        int h = pdb->get_value(state.get_unpacked_values());
+        int h = h_values[i];
         if (h == numeric_limits<int>::max()) {
             return true;
         }
@@ -5,6 +5,7 @@
 
 #include "../algorithms/named_vector.h"
 
+#include "../pdbs/pdb_lookup.h"
 #include "../pdbs/types.h"
 
 #include <memory>
@@ -23,6 +24,7 @@ class PhOConstraints : public ConstraintGenerator {
 
     int constraint_offset;
     std::shared_ptr<pdbs::PDBCollection> pdbs;
+    std::unique_ptr<pdbs::PDBLookup> pdb_lookup;
 public:
     explicit PhOConstraints(const options::Options &opts);
 
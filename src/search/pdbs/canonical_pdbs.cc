@@ -13,7 +13,7 @@ namespace pdbs {
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
+    : pdbs(pdbs), pattern_cliques(pattern_cliques), lookup(*pdbs) {
     assert(pdbs);
     assert(pattern_cliques);
 }
@@ -22,15 +22,13 @@ int CanonicalPDBs::get_value(const State &state) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
     int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
+    const vector<int> &h_values =
+        lookup.compute_values(state.get_unpacked_values());
+    for (int h : h_values) {
         if (h == numeric_limits<int>::max()) {
             return numeric_limits<int>::max();
         }
-        h_values.push_back(h);
     }
     for (const PatternClique &clique : *pattern_cliques) {
         int clique_h = 0;
@@ -1,6 +1,7 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "pdb_lookup.h"
 #include "types.h"
 
 #include <memory>
@@ -11,6 +12,7 @@ namespace pdbs {
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    PDBLookup lookup;
 
 public:
     CanonicalPDBs(
@@ -19,6 +21,10 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+
+    const PDBCollection &get_pattern_databases() const {
+        return *pdbs;
+    }
 };
 }
 
@@ -1,6 +1,7 @@
 #include "canonical_pdbs_heuristic.h"
 
 #include "dominance_pruning.h"
+#include "pattern_database.h"
 #include "pattern_generator.h"
 #include "utils.h"
 
@@ -29,6 +30,9 @@ CanonicalPDBs get_canonical_pdbs_from_options(
         pattern_generator->generate(task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
+    pattern_collection_info.set_pdb_construction_options(
+        opts.get<int>("num_threads"), opts.get<int>("max_concurrent_states"),
+        opts.get<bool>("symbolic"), get_pdb_cache_directory(opts));
     /*
       We compute PDBs and pattern cliques here (if they have not been
       computed before) so that their computation is not taken into account
@@ -79,6 +83,14 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     }
 }
 
+bool CanonicalPDBsHeuristic::get_relevant_variables(set<int> &variables) const {
+    for (const shared_ptr<PatternDatabase> &pdb : canonical_pdbs.get_pattern_databases()) {
+        const Pattern &pattern = pdb->get_pattern();
+        variables.insert(pattern.begin(), pattern.end());
+    }
+    return true;
+}
+
 void add_canonical_pdbs_options_to_parser(options::OptionParser &parser) {
     parser.add_option<double>(
         "max_time_dominance_pruning",
@@ -113,10 +125,12 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "systematic(1)");
 
     add_canonical_pdbs_options_to_parser(parser);
+    add_pdb_construction_options_to_parser(parser);
 
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
+    check_pdb_cache_option(parser, opts);
     if (parser.dry_run())
         return nullptr;
 
@@ -20,6 +20,8 @@ protected:
 public:
     explicit CanonicalPDBsHeuristic(const options::Options &opts);
     virtual ~CanonicalPDBsHeuristic() = default;
+
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
 };
 
 void add_canonical_pdbs_options_to_parser(options::OptionParser &parser);
@@ -0,0 +1,68 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace pdbs {
+DistanceTable::DistanceTable()
+    : entry_bits_log(0),
+      entries_per_word_log(6),
+      entry_mask(1),
+      data(nullptr),
+      num_entries(0) {
+}
+
+DistanceTable::DistanceTable(const vector<int> &distances)
+    : num_entries(distances.size()) {
+    int max_distance = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max())
+            max_distance = max(max_distance, distance);
+    }
+
+    // Reserve the largest code of an entry for dead ends.
+    entry_bits_log = 0;
+    while (entry_bits_log < 5 &&
+           static_cast<uint64_t>(max_distance) + 1 >=
+           (uint64_t(1) << (1 << entry_bits_log)))
+        ++entry_bits_log;
+    int entry_bits = 1 << entry_bits_log;
+    entries_per_word_log = 6 - entry_bits_log;
+    entry_mask = (uint64_t(1) << entry_bits) - 1;
+    assert(static_cast<uint64_t>(max_distance) < entry_mask);
+
+    int entries_per_word = 1 << entries_per_word_log;
+    words.assign(get_num_words(entry_bits, num_entries), 0);
+    for (size_t index = 0; index < distances.size(); ++index) {
+        uint64_t value = distances[index];
+        if (distances[index] == numeric_limits<int>::max())
+            value = entry_mask;
+        int shift = (index & (entries_per_word - 1)) << entry_bits_log;
+        words[index >> entries_per_word_log] |= value << shift;
+    }
+    data = words.data();
+}
+
+DistanceTable::DistanceTable(
+    int bits_per_entry, int num_entries, const uint64_t *data,
+    const shared_ptr<const void> &storage)
+    : entry_bits_log(0),
+      data(data),
+      storage(storage),
+      num_entries(num_entries) {
+    while ((1 << entry_bits_log) < bits_per_entry)
+        ++entry_bits_log;
+    assert(1 << entry_bits_log == bits_per_entry);
+    assert(entry_bits_log <= 5);
+    entries_per_word_log = 6 - entry_bits_log;
+    entry_mask = (uint64_t(1) << bits_per_entry) - 1;
+}
+
+int DistanceTable::get_num_words(int bits_per_entry, int num_entries) {
+    int entries_per_word = 64 / bits_per_entry;
+    return (static_cast<int64_t>(num_entries) + entries_per_word - 1) /
+           entries_per_word;
+}
+}
@@ -0,0 +1,81 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  Stores the goal distances of the abstract states of a PDB with as few
+  bits per entry as possible. Most PDBs have small maximal distances, so
+  instead of 32 bits, an entry only uses the smallest power of two bits
+  (1, 2, 4, 8, 16 or 32) that can represent all finite distances plus a
+  code for dead ends. Entries never straddle word boundaries, so a lookup
+  only needs shifts and masks.
+
+  The words are either owned by the table or stored in external memory,
+  e.g., a memory-mapped file of the PDB cache (see pdb_cache.h), which is
+  kept alive by the table.
+*/
+class DistanceTable {
+    // log2 of the number of bits per entry.
+    int entry_bits_log;
+    // log2 of the number of entries per 64-bit word.
+    int entries_per_word_log;
+    std::uint64_t entry_mask;
+    std::vector<std::uint64_t> words;
+    // Points to the data of words or to external memory owned by storage.
+    const std::uint64_t *data;
+    std::shared_ptr<const void> storage;
+    int num_entries;
+
+public:
+    DistanceTable();
+    // Dead ends are represented by numeric_limits<int>::max().
+    explicit DistanceTable(const std::vector<int> &distances);
+    /*
+      Use the given words (see get_words()) without copying them. They
+      must stay valid as long as storage is alive.
+    */
+    DistanceTable(int bits_per_entry, int num_entries,
+                  const std::uint64_t *data,
+                  const std::shared_ptr<const void> &storage);
+
+    // Moving keeps the data pointer valid, copying would not.
+    DistanceTable(const DistanceTable &) = delete;
+    DistanceTable &operator=(const DistanceTable &) = delete;
+    DistanceTable(DistanceTable &&) = default;
+    DistanceTable &operator=(DistanceTable &&) = default;
+
+    int operator[](int index) const {
+        std::uint64_t word = data[index >> entries_per_word_log];
+        int shift = (index & ((1 << entries_per_word_log) - 1)) << entry_bits_log;
+        std::uint64_t value = (word >> shift) & entry_mask;
+        if (value == entry_mask)
+            return std::numeric_limits<int>::max();
+        return static_cast<int>(value);
+    }
+
+    int size() const {
+        return num_entries;
+    }
+
+    int get_bits_per_entry() const {
+        return 1 << entry_bits_log;
+    }
+
+    static int get_num_words(int bits_per_entry, int num_entries);
+
+    int get_num_words() const {
+        return get_num_words(get_bits_per_entry(), num_entries);
+    }
+
+    const std::uint64_t *get_words() const {
+        return data;
+    }
+};
+}
+
+#endif
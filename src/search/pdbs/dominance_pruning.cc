@@ -3,11 +3,11 @@
 #include "pattern_database.h"
 
 #include "../utils/countdown_timer.h"
-#include "../utils/hash.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_map>
+#include <numeric>
 #include <vector>
 
 using namespace std;
@@ -15,94 +15,96 @@ using namespace std;
 namespace pdbs {
 class Pruner {
     /*
-      Algorithm for pruning dominated patterns.
-
-      "patterns" is the vector of patterns used.
-      Each pattern is a vector of variable IDs.
-
-      "pattern_cliques" is the vector of pattern cliques.
-
-      The algorithm works by setting a "current pattern collection"
-      against which other patterns and collections can be tested for
-      dominance efficiently.
-
-      "variable_to_pattern_id" encodes the relevant information about the
-      current clique. For every variable v, variable_to_pattern_id[v] is
-      the id of the pattern containing v in the current clique,
-      or -1 if the variable is not contained in the current
-      clique. (Note that patterns in a pattern clique must be
-      disjoint, which is verified by an assertion in debug mode.)
-
-      To test if a given pattern v_1, ..., v_k is dominated by the
-      current clique, we check that all entries variable_to_pattern_id[v_i]
-      are equal and different from -1.
-
-      "dominated_patterns" is a vector<bool> that can be used to
-      quickly test whether a given pattern is dominated by the current
-      clique. This is precomputed for every pattern whenever the
-      current clique is set.
+      Algorithm for pruning dominated pattern cliques.
+
+      A clique dominates a pattern if the pattern is a subset of one of
+      the patterns in the clique, and it dominates another clique if it
+      dominates all patterns of the other clique. The patterns in a clique
+      are non-empty and disjoint, so a pattern is dominated by at most one
+      of them. Hence, a clique dominates at least as many patterns as the
+      cliques it dominates, and two different cliques cannot dominate each
+      other.
+
+      We consider the cliques in the order of decreasing numbers of
+      dominated patterns and prune a clique if one of the cliques we kept
+      so far dominates it. This keeps exactly the cliques that are not
+      dominated by another clique, and of duplicate cliques, the first one.
+
+      For every pattern p, "dominating_cliques[p]" contains the indices of
+      the kept cliques that dominate p in increasing order. A clique is
+      dominated by a kept clique iff the lists of all its patterns have a
+      common element.
     */
 
     const PatternCollection &patterns;
     const vector<PatternClique> &pattern_cliques;
-    const int num_variables;
 
-    vector<int> variable_to_pattern_id;
-    vector<bool> dominated_patterns;
-
-    void set_current_clique(int clique_id) {
-        /*
-          Set the current pattern collection to be used for
-          is_pattern_dominated() or is_collection_dominated(). Compute
-          dominated_patterns based on the current pattern collection.
-        */
-        variable_to_pattern_id.assign(num_variables, -1);
-        assert(variable_to_pattern_id == vector<int>(num_variables, -1));
-        for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            for (int variable : patterns[pattern_id]) {
-                assert(variable_to_pattern_id[variable] == -1);
-                variable_to_pattern_id[variable] = pattern_id;
-            }
+    // For every pattern, the IDs of the patterns that are subsets of it.
+    vector<vector<PatternID>> subpatterns;
+    vector<vector<int>> dominating_cliques;
+    int num_kept_cliques;
+
+    void compute_subpatterns(int num_variables) {
+        vector<vector<PatternID>> patterns_by_first_variable(num_variables);
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            assert(!patterns[pattern_id].empty());
+            patterns_by_first_variable[patterns[pattern_id][0]].push_back(
+                pattern_id);
         }
-
-        dominated_patterns.clear();
-        dominated_patterns.reserve(patterns.size());
-        for (size_t i = 0; i < patterns.size(); ++i) {
-            dominated_patterns.push_back(is_pattern_dominated(i));
+        subpatterns.resize(patterns.size());
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            const Pattern &pattern = patterns[pattern_id];
+            for (int variable : pattern) {
+                for (PatternID subpattern_id : patterns_by_first_variable[variable]) {
+                    const Pattern &subpattern = patterns[subpattern_id];
+                    if (includes(pattern.begin(), pattern.end(),
+                                 subpattern.begin(), subpattern.end())) {
+                        subpatterns[pattern_id].push_back(subpattern_id);
+                    }
+                }
+            }
         }
     }
 
-    bool is_pattern_dominated(int pattern_id) const {
+    bool is_clique_dominated(int clique_id) const {
         /*
-          Check if the pattern with the given pattern_id is dominated
-          by the current pattern clique.
+          Check if the clique with the given clique_id is dominated by
+          one of the kept cliques.
         */
-        const Pattern &pattern = patterns[pattern_id];
-        assert(!pattern.empty());
-        PatternID clique_pattern_id = variable_to_pattern_id[pattern[0]];
-        if (clique_pattern_id == -1) {
-            return false;
+        const PatternClique &clique = pattern_cliques[clique_id];
+        if (clique.empty()) {
+            return num_kept_cliques > 0;
         }
-        int pattern_size = pattern.size();
-        for (int i = 1; i < pattern_size; ++i) {
-            if (variable_to_pattern_id[pattern[i]] != clique_pattern_id) {
-                return false;
+        PatternID rarest_pattern_id = clique[0];
+        for (PatternID pattern_id : clique) {
+            if (dominating_cliques[pattern_id].size() <
+                dominating_cliques[rarest_pattern_id].size()) {
+                rarest_pattern_id = pattern_id;
             }
         }
-        return true;
+        for (int kept_clique : dominating_cliques[rarest_pattern_id]) {
+            bool dominates_all = true;
+            for (PatternID pattern_id : clique) {
+                const vector<int> &cliques = dominating_cliques[pattern_id];
+                if (!binary_search(cliques.begin(), cliques.end(), kept_clique)) {
+                    dominates_all = false;
+                    break;
+                }
+            }
+            if (dominates_all) {
+                return true;
+            }
+        }
+        return false;
     }
 
-    bool is_clique_dominated(int clique_id) const {
-        /*
-          Check if the collection with the given collection_id is
-          dominated by the current pattern collection.
-        */
+    void keep_clique(int clique_id) {
         for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            if (!dominated_patterns[pattern_id]) {
-                return false;
+            for (PatternID subpattern_id : subpatterns[pattern_id]) {
+                dominating_cliques[subpattern_id].push_back(num_kept_cliques);
             }
         }
-        return true;
+        ++num_kept_cliques;
     }
 
 public:
@@ -112,33 +114,39 @@ public:
         int num_variables)
         : patterns(patterns),
           pattern_cliques(pattern_cliques),
-          num_variables(num_variables) {
+          dominating_cliques(patterns.size()),
+          num_kept_cliques(0) {
+        compute_subpatterns(num_variables);
     }
 
     vector<bool> get_pruned_cliques(
         const utils::CountdownTimer &timer, utils::LogProxy &log) {
         int num_cliques = pattern_cliques.size();
+        vector<int> num_dominated_patterns(num_cliques, 0);
+        for (int clique_id = 0; clique_id < num_cliques; ++clique_id) {
+            for (PatternID pattern_id : pattern_cliques[clique_id]) {
+                num_dominated_patterns[clique_id] += subpatterns[pattern_id].size();
+            }
+        }
+        vector<int> order(num_cliques);
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int c1, int c2) {
+                        return num_dominated_patterns[c1] > num_dominated_patterns[c2];
+                    });
+
         vector<bool> pruned(num_cliques, false);
-        /*
-          Already pruned cliques are not used to prune other
-          cliques. This makes things faster and helps handle
-          duplicate cliques in the correct way: the first copy
-          will survive and prune all duplicates.
-        */
-        for (int c1 = 0; c1 < num_cliques; ++c1) {
-            if (!pruned[c1]) {
-                set_current_clique(c1);
-                for (int c2 = 0; c2 < num_cliques; ++c2) {
-                    if (c1 != c2 && !pruned[c2] && is_clique_dominated(c2))
-                        pruned[c2] = true;
-                }
+        for (int clique_id : order) {
+            if (is_clique_dominated(clique_id)) {
+                pruned[clique_id] = true;
+            } else {
+                keep_clique(clique_id);
             }
             if (timer.is_expired()) {
                 /*
-                  Since after each iteration, we determined if a given
-                  clique is pruned or not, we can just break the
-                  computation here if reaching the time limit and use all
-                  information we collected so far.
+                  We determined for all cliques considered so far if they
+                  are pruned or not, so we can just break the computation
+                  here if reaching the time limit and keep all remaining
+                  cliques.
                 */
                 if (log.is_at_least_normal()) {
                     log << "Time limit reached. Abort dominance pruning." << endl;
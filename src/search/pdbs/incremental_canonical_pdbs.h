@@ -1,6 +1,7 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "pattern_cliques.h"
 #include "pattern_collection_information.h"
 #include "types.h"
@@ -16,6 +17,8 @@ class IncrementalCanonicalPDBs {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Rebuilt whenever the collection changes.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
@@ -37,7 +40,7 @@ public:
 
     /* Returns a list of pattern cliques that would be additive to the new
        pattern. Detailed documentation in max_additive_pdb_sets.h */
-    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern);
+    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern) const;
 
     int get_value(const State &state) const;
 
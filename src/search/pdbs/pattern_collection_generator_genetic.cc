@@ -33,6 +33,10 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
+      num_threads(opts.get<int>("num_threads")),
+      max_concurrent_states(opts.get<int>("max_concurrent_states")),
+      symbolic(opts.get<bool>("symbolic")),
+      cache_directory(get_pdb_cache_directory(opts)),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
@@ -204,7 +208,9 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
         } else {
             /* Generate the pattern collection heuristic and get its fitness
                value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
+            ZeroOnePDBs zero_one_pdbs(
+                task_proxy, *pattern_collection, num_threads,
+                max_concurrent_states, symbolic, cache_directory, log);
             fitness = zero_one_pdbs.compute_approx_mean_finite_h();
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
@@ -381,11 +387,13 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "consider a pattern collection invalid (giving it very low "
         "fitness) if its patterns are not disjoint",
         "false");
+    add_pdb_construction_options_to_parser(parser);
 
     utils::add_rng_options(parser);
     add_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
+    check_pdb_cache_option(parser, opts);
     if (parser.dry_run())
         return nullptr;
 
@@ -5,6 +5,7 @@
 #include "types.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class AbstractTask;
@@ -29,6 +30,11 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     /* Specifies whether patterns in each pattern collection need to be disjoint
        or not. */
     const bool disjoint_patterns;
+    // Options for computing the PDBs of a collection concurrently.
+    const int num_threads;
+    const int max_concurrent_states;
+    const bool symbolic;
+    const std::string cache_directory;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::shared_ptr<AbstractTask> task;
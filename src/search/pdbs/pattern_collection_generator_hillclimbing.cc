@@ -13,17 +13,19 @@
 #include "../task_utils/sampling.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
-#include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <limits>
 #include <string>
@@ -120,9 +122,12 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(opts.get<int>("num_threads")),
+      max_concurrent_states(opts.get<int>("max_concurrent_states")),
+      symbolic(opts.get<bool>("symbolic")),
+      cache_directory(get_pdb_cache_directory(opts)),
       rng(utils::parse_rng_from_options(opts)),
-      num_rejected(0),
-      hill_climbing_timer(0) {
+      num_rejected(0) {
 }
 
 int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
@@ -133,7 +138,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -160,16 +165,22 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    shared_ptr<PDBCollection> new_pdbs = compute_pdbs(
+        task_proxy, new_patterns, num_threads, max_concurrent_states,
+        symbolic, cache_directory, log);
+    int max_pdb_size = 0;
+    for (const shared_ptr<PatternDatabase> &new_pdb : *new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(new_pdb);
+    }
     return max_pdb_size;
 }
 
@@ -186,7 +197,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
                               [this](const State &state) {
                                   return current_pdbs->is_dead_end(state);
                               }));
-        if (hill_climbing_timer->is_expired()) {
+        if (is_hill_climbing_time_expired()) {
             throw HillClimbingTimeout();
         }
     }
@@ -195,6 +206,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     const vector<State> &samples,
     const vector<int> &samples_h_values,
+    const vector<int> &samples_pdb_values,
     PDBCollection &candidate_pdbs) {
     /*
       TODO: The original implementation by Haslum et al. uses A* to compute
@@ -206,50 +218,63 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
         /*
           If a candidate's size added to the current collection's size exceeds
           the maximum collection size, then forget the pdb.
         */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
+        if (pdb && current_pdbs->get_size() + pdb->get_size() > collection_max_size)
             candidate_pdbs[i] = nullptr;
-            continue;
-        }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+      The candidates are evaluated independently of each other, so we can
+      distribute them over several threads. We cannot throw an exception
+      from a worker thread, so a timeout is only recorded there.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    int num_pdbs = current_pdbs->get_pattern_databases()->size();
+    vector<int> counts(candidate_pdbs.size(), 0);
+    atomic<bool> timed_out(false);
+    utils::parallel_for(candidate_pdbs.size(), num_threads, [&](int i) {
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb || timed_out) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
             }
-        }
+            if (is_hill_climbing_time_expired()) {
+                timed_out = true;
+                return;
+            }
+            vector<PatternClique> pattern_cliques =
+                current_pdbs->get_pattern_cliques(pdb->get_pattern());
+            int count = 0;
+            for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                assert(utils::in_bounds(sample_id, samples_h_values));
+                if (is_heuristic_improved(
+                        *pdb, samples[sample_id], samples_h_values[sample_id],
+                        &samples_pdb_values[sample_id * num_pdbs],
+                        pattern_cliques)) {
+                    ++count;
+                }
+            }
+            counts[i] = count;
+        });
+    if (timed_out)
+        throw HillClimbingTimeout();
+
+    // Search for the best improving pattern/pdb in the original order.
+    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -265,7 +290,7 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
+    const int *h_values, const vector<PatternClique> &pattern_cliques) const {
     const vector<int> &sample_data = sample.get_unpacked_values();
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample_data);
@@ -278,14 +303,6 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     if (h_collection == numeric_limits<int>::max())
         return false;
 
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
-        if (h == numeric_limits<int>::max())
-            return false;
-        h_values.push_back(h);
-    }
     for (const PatternClique &clilque : pattern_cliques) {
         int h_clique = 0;
         for (PatternID pattern_id : clilque) {
@@ -302,9 +319,18 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     return false;
 }
 
+double PatternCollectionGeneratorHillclimbing::get_hill_climbing_time() const {
+    return chrono::duration<double>(
+        chrono::steady_clock::now() - hill_climbing_start_time).count();
+}
+
+bool PatternCollectionGeneratorHillclimbing::is_hill_climbing_time_expired() const {
+    return get_hill_climbing_time() >= max_time;
+}
+
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy) {
-    hill_climbing_timer = new utils::CountdownTimer(max_time);
+    hill_climbing_start_time = chrono::steady_clock::now();
 
     if (log.is_at_least_normal()) {
         log << "Average operator cost: "
@@ -343,6 +369,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     sampling::RandomWalkSampler sampler(task_proxy, *rng);
     vector<State> samples;
     vector<int> samples_h_values;
+    vector<int> samples_pdb_values;
 
     try {
         while (true) {
@@ -365,13 +392,27 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
             samples.clear();
             samples_h_values.clear();
+            samples_pdb_values.clear();
             sample_states(sampler, init_h, samples);
+            const PDBCollection &pdbs = *current_pdbs->get_pattern_databases();
             for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
+                int h_collection = current_pdbs->get_value(sample);
+                samples_h_values.push_back(h_collection);
+                const vector<int> &sample_data = sample.get_unpacked_values();
+                /*
+                  The h-values of the current PDBs are the same for all
+                  candidates, so we only compute them once per sample.
+                */
+                for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+                    int h = pdb->get_value(sample_data);
+                    assert(h != numeric_limits<int>::max() ||
+                           h_collection == numeric_limits<int>::max());
+                    samples_pdb_values.push_back(h);
+                }
             }
 
-            pair<int, int> improvement_and_index =
-                find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
+            pair<int, int> improvement_and_index = find_best_improving_pdb(
+                samples, samples_h_values, samples_pdb_values, candidate_pdbs);
             int improvement = improvement_and_index.first;
             int best_pdb_index = improvement_and_index.second;
 
@@ -408,7 +449,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
             if (log.is_at_least_verbose()) {
                 log << "Hill climbing time so far: "
-                    << hill_climbing_timer->get_elapsed_time()
+                    << utils::Duration(get_hill_climbing_time())
                     << endl;
             }
         }
@@ -424,11 +465,8 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
         log << "Hill climbing rejected patterns: " << num_rejected << endl;
         log << "Hill climbing maximum PDB size: " << max_pdb_size << endl;
         log << "Hill climbing time: "
-            << hill_climbing_timer->get_elapsed_time() << endl;
+            << utils::Duration(get_hill_climbing_time()) << endl;
     }
-
-    delete hill_climbing_timer;
-    hill_climbing_timer = nullptr;
 }
 
 string PatternCollectionGeneratorHillclimbing::name() const {
@@ -547,17 +585,20 @@ void add_hillclimbing_options(OptionParser &parser) {
         "max_time",
         "maximum time in seconds for improving the initial pattern "
         "collection via hill climbing. If set to 0, no hill climbing "
-        "is performed at all. Note that this limit only affects hill "
+        "is performed at all. The time is measured as wall-clock time, "
+        "so the limit does not depend on num_threads. Note that this limit only affects hill "
         "climbing. Use max_time_dominance_pruning to limit the time "
         "spent for pruning dominated patterns.",
         "infinity",
         Bounds("0.0", "infinity"));
+    add_pdb_construction_options_to_parser(parser);
     utils::add_rng_options(parser);
     add_generator_options_to_parser(parser);
 }
 
 void check_hillclimbing_options(
     OptionParser &parser, const Options &opts) {
+    check_pdb_cache_option(parser, opts);
     if (opts.get<int>("min_improvement") > opts.get<int>("num_samples"))
         parser.error("minimum improvement must not be higher than number of "
                      "samples");
@@ -664,6 +705,13 @@ static shared_ptr<Heuristic> _parse_ipdb(OptionParser &parser) {
         "patterns", pgh);
     heuristic_opts.set<double>(
         "max_time_dominance_pruning", opts.get<double>("max_time_dominance_pruning"));
+    heuristic_opts.set<int>(
+        "num_threads", opts.get<int>("num_threads"));
+    heuristic_opts.set<int>(
+        "max_concurrent_states", opts.get<int>("max_concurrent_states"));
+    heuristic_opts.set<bool>("symbolic", opts.get<bool>("symbolic"));
+    heuristic_opts.set<string>(
+        "cache_directory", opts.get<string>("cache_directory"));
 
     return make_shared<CanonicalPDBsHeuristic>(heuristic_opts);
 }
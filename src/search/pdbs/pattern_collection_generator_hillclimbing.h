@@ -6,13 +6,14 @@
 
 #include "../task_proxy.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace utils {
-class CountdownTimer;
 class RandomNumberGenerator;
 }
 
@@ -35,20 +36,34 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    // number of threads for building and evaluating candidate PDBs
+    const int num_threads;
+    const int max_concurrent_states;
+    const bool symbolic;
+    const std::string cache_directory;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
 
     // for stats only
     int num_rejected;
-    utils::CountdownTimer *hill_climbing_timer;
+
+    /*
+      max_time is measured in wall-clock time. CPU time would add up over
+      the threads, so more threads would end hill climbing earlier.
+    */
+    std::chrono::steady_clock::time_point hill_climbing_start_time;
+
+    double get_hill_climbing_time() const;
+    bool is_hill_climbing_time_expired() const;
 
     /*
       For the given PDB, all possible extensions of its pattern by one
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The
+      new PDBs are built on up to num_threads threads (see compute_pdbs).
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -78,24 +93,31 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      samples_pdb_values holds the h-values of the PDBs of the current
+      collection for all samples (one row of values per sample). The
+      candidates are evaluated on up to num_threads threads, but ties are
+      broken as in a sequential evaluation.
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
         const std::vector<int> &samples_h_values,
+        const std::vector<int> &samples_pdb_values,
         PDBCollection &candidate_pdbs);
 
     /*
       Returns true iff the h-value of the new pattern (from pdb) plus the
       h-value of all pattern cliques from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection. h_values holds the
+      h-values of the PDBs of the current collection for the sample.
     */
     bool is_heuristic_improved(
         const PatternDatabase &pdb,
         const State &sample,
         int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        const int *h_values,
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
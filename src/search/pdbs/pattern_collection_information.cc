@@ -2,6 +2,7 @@
 
 #include "pattern_database.h"
 #include "pattern_cliques.h"
+#include "utils.h"
 #include "validation.h"
 
 #include "../utils/logging.h"
@@ -9,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <unordered_set>
 #include <utility>
 
@@ -23,7 +25,10 @@ PatternCollectionInformation::PatternCollectionInformation(
       patterns(patterns),
       pdbs(nullptr),
       pattern_cliques(nullptr),
-      log(log) {
+      log(log),
+      num_threads(1),
+      max_concurrent_states(numeric_limits<int>::max()),
+      symbolic(false) {
     assert(patterns);
     validate_and_normalize_patterns(task_proxy, *patterns, log);
 }
@@ -62,12 +67,9 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
         if (log.is_at_least_normal()) {
             log << "Computing PDBs for pattern collection..." << endl;
         }
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                make_shared<PatternDatabase>(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = compute_pdbs(
+            task_proxy, *patterns, num_threads, max_concurrent_states,
+            symbolic, cache_directory, log);
         if (log.is_at_least_normal()) {
             log << "Done computing PDBs for pattern collection: "
                 << timer << endl;
@@ -95,6 +97,15 @@ void PatternCollectionInformation::set_pdbs(const shared_ptr<PDBCollection> &pdb
     assert(information_is_valid());
 }
 
+void PatternCollectionInformation::set_pdb_construction_options(
+    int num_threads_, int max_concurrent_states_, bool symbolic_,
+    const string &cache_directory_) {
+    num_threads = num_threads_;
+    max_concurrent_states = max_concurrent_states_;
+    symbolic = symbolic_;
+    cache_directory = cache_directory_;
+}
+
 void PatternCollectionInformation::set_pattern_cliques(
     const shared_ptr<vector<PatternClique>> &pattern_cliques_) {
     pattern_cliques = pattern_cliques_;
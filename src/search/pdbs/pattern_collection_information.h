@@ -6,6 +6,7 @@
 #include "../task_proxy.h"
 
 #include <memory>
+#include <string>
 
 namespace utils {
 class LogProxy;
@@ -30,6 +31,11 @@ class PatternCollectionInformation {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
     utils::LogProxy &log;
+    // Used if the PDBs have to be computed (see compute_pdbs).
+    int num_threads;
+    int max_concurrent_states;
+    bool symbolic;
+    std::string cache_directory;
 
     void create_pdbs_if_missing();
     void create_pattern_cliques_if_missing();
@@ -43,6 +49,9 @@ public:
     ~PatternCollectionInformation() = default;
 
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
+    void set_pdb_construction_options(
+        int num_threads, int max_concurrent_states, bool symbolic,
+        const std::string &cache_directory);
     void set_pattern_cliques(
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
 
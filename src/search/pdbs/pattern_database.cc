@@ -1,17 +1,20 @@
 #include "pattern_database.h"
 
 #include "match_tree.h"
+#include "pdb_cache.h"
 
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <limits>
@@ -78,8 +81,11 @@ PatternDatabase::PatternDatabase(
     const vector<int> &operator_costs,
     bool compute_plan,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
-    bool compute_wildcard_plan)
-    : pattern(pattern) {
+    bool compute_wildcard_plan,
+    bool symbolic,
+    const string &cache_directory)
+    : pattern(pattern),
+      cache_write_failed(false) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
     assert(operator_costs.empty() ||
@@ -101,7 +107,22 @@ PatternDatabase::PatternDatabase(
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
     }
-    create_pdb(task_proxy, operator_costs, compute_plan, rng, compute_wildcard_plan);
+    if (symbolic) {
+        assert(!compute_plan);
+        symbolic_distances = utils::make_unique_ptr<SymbolicDistances>(
+            task_proxy, pattern, operator_costs);
+    } else if (!cache_directory.empty() && !compute_plan) {
+        vector<int> cache_key =
+            compute_pdb_cache_key(task_proxy, pattern, operator_costs);
+        if (!load_cached_distances(cache_directory, cache_key, distances)) {
+            create_pdb(task_proxy, operator_costs, false, rng, false);
+            cache_write_failed = !store_cached_distances(
+                cache_directory, cache_key, distances);
+        }
+    } else {
+        create_pdb(task_proxy, operator_costs, compute_plan, rng,
+                   compute_wildcard_plan);
+    }
 }
 
 void PatternDatabase::multiply_out(
@@ -111,7 +132,7 @@ void PatternDatabase::multiply_out(
     const vector<FactPair> &effects_without_pre,
     const VariablesProxy &variables,
     int concrete_op_id,
-    vector<AbstractOperator> &operators) {
+    vector<AbstractOperator> &operators) const {
     if (pos == static_cast<int>(effects_without_pre.size())) {
         // All effects without precondition have been checked: insert op.
         if (!eff_pairs.empty()) {
@@ -148,7 +169,18 @@ void PatternDatabase::build_abstract_operators(
     const OperatorProxy &op, int cost,
     const vector<int> &variable_to_index,
     const VariablesProxy &variables,
-    vector<AbstractOperator> &operators) {
+    vector<AbstractOperator> &operators) const {
+    // Operators without effects on the pattern induce no abstract operators.
+    bool affects_pattern = false;
+    for (EffectProxy eff : op.get_effects()) {
+        if (variable_to_index[eff.get_fact().get_variable().get_id()] != -1) {
+            affects_pattern = true;
+            break;
+        }
+    }
+    if (!affects_pattern)
+        return;
+
     // All variable value pairs that are a prevail condition
     vector<FactPair> prev_pairs;
     // All variable value pairs that are a precondition (value != -1)
@@ -194,6 +226,62 @@ void PatternDatabase::build_abstract_operators(
                  variables, op.get_id(), operators);
 }
 
+/*
+  Distances are computed layer by layer (see compute_distances_by_layers)
+  if no operator is more expensive than this.
+*/
+static const int MAX_COST_FOR_LAYERS = 1000;
+
+/*
+  Call callback for the indices of all abstract states that satisfy the
+  given facts over pattern variables, in increasing order. The values of
+  the first unconstrained variable are enumerated in the innermost loop,
+  which accesses indices with a constant stride.
+*/
+template<typename Callback>
+static void for_each_matching_index(
+    const vector<FactPair> &facts, const vector<int> &hash_multipliers,
+    const vector<int> &domain_sizes, const Callback &callback) {
+    int num_vars = domain_sizes.size();
+    vector<bool> is_constrained(num_vars, false);
+    int64_t index = 0;
+    for (const FactPair &fact : facts) {
+        is_constrained[fact.var] = true;
+        index += static_cast<int64_t>(fact.value) * hash_multipliers[fact.var];
+    }
+    vector<int> free_vars;
+    for (int var = 0; var < num_vars; ++var) {
+        if (!is_constrained[var])
+            free_vars.push_back(var);
+    }
+    if (free_vars.empty()) {
+        callback(static_cast<int>(index));
+        return;
+    }
+
+    int inner_multiplier = hash_multipliers[free_vars[0]];
+    int inner_domain_size = domain_sizes[free_vars[0]];
+    vector<int> values(free_vars.size(), 0);
+    while (true) {
+        int inner_index = static_cast<int>(index);
+        for (int value = 0; value < inner_domain_size; ++value) {
+            callback(inner_index);
+            inner_index += inner_multiplier;
+        }
+        size_t pos = 1;
+        for (; pos < free_vars.size(); ++pos) {
+            int var = free_vars[pos];
+            index += hash_multipliers[var];
+            if (++values[pos] < domain_sizes[var])
+                break;
+            index -= static_cast<int64_t>(domain_sizes[var]) * hash_multipliers[var];
+            values[pos] = 0;
+        }
+        if (pos == free_vars.size())
+            return;
+    }
+}
+
 void PatternDatabase::create_pdb(
     const TaskProxy &task_proxy, const vector<int> &operator_costs,
     bool compute_plan, const shared_ptr<utils::RandomNumberGenerator> &rng,
@@ -217,13 +305,6 @@ void PatternDatabase::create_pdb(
             op, op_cost, variable_to_index, variables, operators);
     }
 
-    // build the match tree
-    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
-    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
-        const AbstractOperator &op = operators[op_id];
-        match_tree.insert(op_id, op.get_regression_preconditions());
-    }
-
     // compute abstract goal var-val pairs
     vector<FactPair> abstract_goals;
     for (FactProxy goal : task_proxy.get_goals()) {
@@ -234,19 +315,39 @@ void PatternDatabase::create_pdb(
         }
     }
 
-    distances.reserve(num_states);
+    int max_cost = 0;
+    for (const AbstractOperator &op : operators) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+    if (!compute_plan && max_cost <= MAX_COST_FOR_LAYERS) {
+        distances = DistanceTable(compute_distances_by_layers(
+                                      task_proxy, operators, abstract_goals, max_cost));
+        return;
+    }
+
+    // build the match tree
+    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
+    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+        const AbstractOperator &op = operators[op_id];
+        match_tree.insert(op_id, op.get_regression_preconditions());
+    }
+
+    vector<int> domain_sizes;
+    for (int var_id : pattern) {
+        domain_sizes.push_back(variables[var_id].get_domain_size());
+    }
+
+    vector<int> goal_distances(num_states, numeric_limits<int>::max());
     // first implicit entry: priority, second entry: index for an abstract state
     priority_queues::AdaptiveQueue<int> pq;
 
     // initialize queue
-    for (int state_index = 0; state_index < num_states; ++state_index) {
-        if (is_goal_state(state_index, abstract_goals, variables)) {
+    for_each_matching_index(
+        abstract_goals, hash_multipliers, domain_sizes,
+        [&](int state_index) {
             pq.push(0, state_index);
-            distances.push_back(0);
-        } else {
-            distances.push_back(numeric_limits<int>::max());
-        }
-    }
+            goal_distances[state_index] = 0;
+        });
 
     if (compute_plan) {
         /*
@@ -263,23 +364,24 @@ void PatternDatabase::create_pdb(
     }
 
     // Dijkstra loop
+    vector<int> applicable_operator_ids;
     while (!pq.empty()) {
         pair<int, int> node = pq.pop();
         int distance = node.first;
         int state_index = node.second;
-        if (distance > distances[state_index]) {
+        if (distance > goal_distances[state_index]) {
             continue;
         }
 
         // regress abstract_state
-        vector<int> applicable_operator_ids;
+        applicable_operator_ids.clear();
         match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
         for (int op_id : applicable_operator_ids) {
             const AbstractOperator &op = operators[op_id];
             int predecessor = state_index + op.get_hash_effect();
-            int alternative_cost = distances[state_index] + op.get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
+            int alternative_cost = goal_distances[state_index] + op.get_cost();
+            if (alternative_cost < goal_distances[predecessor]) {
+                goal_distances[predecessor] = alternative_cost;
                 pq.push(alternative_cost, predecessor);
                 if (compute_plan) {
                     generating_op_ids[predecessor] = op_id;
@@ -306,7 +408,7 @@ void PatternDatabase::create_pdb(
         initial_state.unpack();
         int current_state =
             hash_index(initial_state.get_unpacked_values());
-        if (distances[current_state] != numeric_limits<int>::max()) {
+        if (goal_distances[current_state] != numeric_limits<int>::max()) {
             while (!is_goal_state(current_state, abstract_goals, variables)) {
                 int op_id = generating_op_ids[current_state];
                 assert(op_id != -1);
@@ -338,6 +440,71 @@ void PatternDatabase::create_pdb(
         }
         utils::release_vector_memory(generating_op_ids);
     }
+
+    distances = DistanceTable(goal_distances);
+}
+
+vector<int> PatternDatabase::compute_distances_by_layers(
+    const TaskProxy &task_proxy,
+    const vector<AbstractOperator> &operators,
+    const vector<FactPair> &abstract_goals,
+    int max_cost) const {
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> domain_sizes;
+    for (int var_id : pattern) {
+        domain_sizes.push_back(variables[var_id].get_domain_size());
+    }
+
+    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
+    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+        const AbstractOperator &op = operators[op_id];
+        match_tree.insert(op_id, op.get_regression_preconditions());
+    }
+
+    /*
+      The states with distance d are collected in bucket d modulo
+      (max_cost + 1). A state is added to a bucket whenever its distance
+      decreases, so buckets can contain states that have a smaller
+      distance by now. We skip these when expanding the bucket. Zero-cost
+      operators add states to the bucket that is currently expanded.
+    */
+    vector<int> goal_distances(num_states, numeric_limits<int>::max());
+    vector<vector<int>> buckets(max_cost + 1);
+    for_each_matching_index(
+        abstract_goals, hash_multipliers, domain_sizes,
+        [&](int state_index) {
+            goal_distances[state_index] = 0;
+            buckets[0].push_back(state_index);
+        });
+    int64_t num_bucket_entries = buckets[0].size();
+
+    vector<int> applicable_operator_ids;
+    for (int distance = 0; num_bucket_entries > 0; ++distance) {
+        vector<int> &layer = buckets[distance % buckets.size()];
+        for (size_t i = 0; i < layer.size(); ++i) {
+            int state_index = layer[i];
+            if (goal_distances[state_index] != distance) {
+                continue;
+            }
+            applicable_operator_ids.clear();
+            match_tree.get_applicable_operator_ids(
+                state_index, applicable_operator_ids);
+            for (int op_id : applicable_operator_ids) {
+                const AbstractOperator &op = operators[op_id];
+                int predecessor = state_index + op.get_hash_effect();
+                int alternative_cost = distance + op.get_cost();
+                if (alternative_cost < goal_distances[predecessor]) {
+                    goal_distances[predecessor] = alternative_cost;
+                    buckets[alternative_cost % buckets.size()].push_back(
+                        predecessor);
+                    ++num_bucket_entries;
+                }
+            }
+        }
+        num_bucket_entries -= layer.size();
+        layer.clear();
+    }
+    return goal_distances;
 }
 
 bool PatternDatabase::is_goal_state(
@@ -366,13 +533,17 @@ int PatternDatabase::hash_index(const vector<int> &state) const {
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
+    if (symbolic_distances)
+        return symbolic_distances->get_value(state);
     return distances[hash_index(state)];
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
+    if (symbolic_distances)
+        return symbolic_distances->get_mean_finite_h();
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
+    for (int i = 0; i < distances.size(); ++i) {
         if (distances[i] != numeric_limits<int>::max()) {
             sum += distances[i];
             ++size;
@@ -394,4 +565,53 @@ bool PatternDatabase::is_operator_relevant(const OperatorProxy &op) const {
     }
     return false;
 }
+
+vector<int> PatternDatabase::compute_saturated_costs(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs) const {
+    assert(!is_symbolic());
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> variable_to_index(variables.size(), -1);
+    vector<int> domain_sizes;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        variable_to_index[pattern[i]] = i;
+        domain_sizes.push_back(variables[pattern[i]].get_domain_size());
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<int> saturated_costs(operators.size(), 0);
+    vector<AbstractOperator> abstract_operators;
+    for (OperatorProxy op : operators) {
+        int cost = operator_costs.empty() ?
+            op.get_cost() : operator_costs[op.get_id()];
+        if (cost == 0)
+            continue;
+        int &saturated_cost = saturated_costs[op.get_id()];
+        abstract_operators.clear();
+        build_abstract_operators(
+            op, cost, variable_to_index, variables, abstract_operators);
+        for (const AbstractOperator &abstract_op : abstract_operators) {
+            // No transition needs more than the full cost.
+            if (saturated_cost == cost)
+                break;
+            int hash_effect = abstract_op.get_hash_effect();
+            /*
+              The regression preconditions match the targets t of the
+              transitions, whose sources are t + hash_effect. Since
+              h(s) <= cost + h(t), h(s) is finite if h(t) is.
+            */
+            for_each_matching_index(
+                abstract_op.get_regression_preconditions(), hash_multipliers,
+                domain_sizes, [&](int state_index) {
+                    int h = distances[state_index];
+                    if (h != numeric_limits<int>::max()) {
+                        saturated_cost = max(
+                            saturated_cost,
+                            distances[state_index + hash_effect] - h);
+                    }
+                });
+        }
+        assert(saturated_cost <= cost);
+    }
+    return saturated_costs;
+}
 }
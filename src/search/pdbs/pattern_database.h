@@ -1,10 +1,15 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
+#include "symbolic_distances.h"
 #include "types.h"
 
 #include "../task_proxy.h"
 
+#include <cassert>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -92,7 +97,9 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    DistanceTable distances;
+    // Replaces distances for symbolic PDBs.
+    std::unique_ptr<SymbolicDistances> symbolic_distances;
 
     std::vector<int> generating_op_ids;
     std::vector<std::vector<OperatorID>> wildcard_plan;
@@ -100,6 +107,8 @@ class PatternDatabase {
     // multipliers for each variable for perfect hash function
     std::vector<int> hash_multipliers;
 
+    bool cache_write_failed;
+
     /*
       Recursive method; called by build_abstract_operators. In the case
       of a precondition with value = -1 in the concrete operator, all
@@ -115,7 +124,7 @@ class PatternDatabase {
         const std::vector<FactPair> &effects_without_pre,
         const VariablesProxy &variables,
         int concrete_op_id,
-        std::vector<AbstractOperator> &operators);
+        std::vector<AbstractOperator> &operators) const;
 
     /*
       Computes all abstract operators for a given concrete operator (by
@@ -127,12 +136,14 @@ class PatternDatabase {
         const OperatorProxy &op, int cost,
         const std::vector<int> &variable_to_index,
         const VariablesProxy &variables,
-        std::vector<AbstractOperator> &operators);
+        std::vector<AbstractOperator> &operators) const;
 
     /*
       Computes all abstract operators, builds the match tree (successor
       generator) and then does a Dijkstra regression search to compute
-      all final h-values (stored in distances). operator_costs can
+      all final h-values (stored in distances). If no plan is needed and
+      all costs are small, the search uses buckets of states with equal
+      distance instead (see compute_distances_by_layers). operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
     */
@@ -143,6 +154,17 @@ class PatternDatabase {
         const std::shared_ptr<utils::RandomNumberGenerator> &rng,
         bool compute_wildcard_plan);
 
+    /*
+      Computes the goal distances for operators with costs of at most
+      max_cost with a regression search that expands all states with
+      the same distance together (see create_pdb).
+    */
+    std::vector<int> compute_distances_by_layers(
+        const TaskProxy &task_proxy,
+        const std::vector<AbstractOperator> &operators,
+        const std::vector<FactPair> &abstract_goals,
+        int max_cost) const;
+
     /*
       For a given abstract state (given as index), the according values
       for each variable in the state are computed and compared with the
@@ -174,6 +196,15 @@ public:
        compute_wildcard_plan: when computing a plan (see compute_plan), compute
        a wildcard plan, i.e., a sequence of parallel operators inducing an
        optimal plan. Otherwise, compute a simple plan (a sequence of operators).
+       symbolic: if true, compute the distances with a symbolic search and
+       store them as a decision diagram (see SymbolicDistances) instead of
+       an explicit table. Symbolic PDBs cannot compute plans.
+       cache_directory: if not empty, load the distances from the PDB cache
+       in this directory if it contains them and store them there
+       otherwise (see pdb_cache.h). Only used for explicit PDBs without
+       plans. A failure to store the distances is not logged, since PDBs
+       may be computed on several threads, but can be queried with
+       has_cache_write_failed().
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
@@ -181,11 +212,35 @@ public:
         const std::vector<int> &operator_costs = std::vector<int>(),
         bool compute_plan = false,
         const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
-        bool compute_wildcard_plan = false);
+        bool compute_wildcard_plan = false,
+        bool symbolic = false,
+        const std::string &cache_directory = std::string());
     ~PatternDatabase() = default;
 
     int get_value(const std::vector<int> &state) const;
 
+    bool is_symbolic() const {
+        return symbolic_distances != nullptr;
+    }
+
+    bool has_cache_write_failed() const {
+        return cache_write_failed;
+    }
+
+    /*
+      The index of an abstract state is the sum of the values of the
+      pattern variables times their multipliers. Symbolic PDBs have no
+      indices.
+    */
+    const std::vector<int> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
+    int get_value_for_index(int index) const {
+        assert(!is_symbolic());
+        return distances[index];
+    }
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -212,6 +267,19 @@ public:
 
     // Returns true iff op has an effect on a variable in the pattern.
     bool is_operator_relevant(const OperatorProxy &op) const;
+
+    /*
+      Returns the saturated cost of each operator, i.e., the minimal cost
+      that preserves all goal distances of the PDB: the maximum of
+      h(s) - h(t) over all abstract transitions from s to t induced by
+      the operator with h(t) < infinity, or 0 if this is negative.
+      operator_costs must be the costs the PDB was computed with (empty
+      for the default operator costs). The saturated cost of an operator
+      never exceeds its cost. Not supported for symbolic PDBs.
+    */
+    std::vector<int> compute_saturated_costs(
+        const TaskProxy &task_proxy,
+        const std::vector<int> &operator_costs = std::vector<int>()) const;
 };
 }
 
@@ -14,7 +14,8 @@ PatternInformation::PatternInformation(
     utils::LogProxy &log)
     : task_proxy(task_proxy),
       pattern(move(pattern)),
-      pdb(nullptr) {
+      pdb(nullptr),
+      symbolic(false) {
     validate_and_normalize_pattern(task_proxy, this->pattern, log);
 }
 
@@ -24,7 +25,9 @@ bool PatternInformation::information_is_valid() const {
 
 void PatternInformation::create_pdb_if_missing() {
     if (!pdb) {
-        pdb = make_shared<PatternDatabase>(task_proxy, pattern);
+        pdb = make_shared<PatternDatabase>(
+            task_proxy, pattern, vector<int>(), false, nullptr, false,
+            symbolic, cache_directory);
     }
 }
 
@@ -33,6 +36,12 @@ void PatternInformation::set_pdb(const shared_ptr<PatternDatabase> &pdb_) {
     assert(information_is_valid());
 }
 
+void PatternInformation::set_pdb_construction_options(
+    bool symbolic_, const string &cache_directory_) {
+    symbolic = symbolic_;
+    cache_directory = cache_directory_;
+}
+
 const Pattern &PatternInformation::get_pattern() const {
     return pattern;
 }
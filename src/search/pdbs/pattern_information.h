@@ -6,6 +6,7 @@
 #include "../task_proxy.h"
 
 #include <memory>
+#include <string>
 
 namespace utils {
 class LogProxy;
@@ -27,6 +28,9 @@ class PatternInformation {
     TaskProxy task_proxy;
     Pattern pattern;
     std::shared_ptr<PatternDatabase> pdb;
+    // Used if the PDB has to be computed.
+    bool symbolic;
+    std::string cache_directory;
 
     void create_pdb_if_missing();
 
@@ -36,6 +40,8 @@ public:
         const TaskProxy &task_proxy, Pattern pattern, utils::LogProxy &log);
 
     void set_pdb(const std::shared_ptr<PatternDatabase> &pdb);
+    void set_pdb_construction_options(
+        bool symbolic, const std::string &cache_directory);
 
     TaskProxy get_task_proxy() const {
         return task_proxy;
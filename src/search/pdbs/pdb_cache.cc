@@ -0,0 +1,240 @@
+#include "pdb_cache.h"
+
+#include "distance_table.h"
+
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace pdbs {
+/*
+  A cache file starts with a header of 64-bit words: the magic number, the
+  number of entries of the key, the bits per entry and the number of
+  entries of the table. The key follows as 32-bit integers, padded to a
+  multiple of 64 bits, and then the words of the table. The format is only
+  meant to be read on the machine that wrote it, so we use the native byte
+  order.
+*/
+static const uint64_t MAGIC_NUMBER = 0x3230424450444600; // "\0FDPDB02"
+static const int NUM_HEADER_WORDS = 4;
+
+/*
+  Smaller tables are copied into memory, which is cheaper than mapping
+  them and does not count a page per table towards the memory usage.
+*/
+static const uint64_t MIN_TABLE_BYTES_FOR_MAPPING = 1 << 20;
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+namespace {
+class MappedFile {
+    void *address;
+    size_t size;
+public:
+    MappedFile()
+        : address(nullptr), size(0) {
+    }
+
+    ~MappedFile() {
+        if (address)
+            munmap(address, size);
+    }
+
+    bool map(const string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+        struct stat file_status;
+        if (fstat(fd, &file_status) == 0 && file_status.st_size > 0) {
+            size = file_status.st_size;
+            address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED)
+                address = nullptr;
+        }
+        close(fd);
+        return address != nullptr;
+    }
+
+    const char *get_data() const {
+        return static_cast<const char *>(address);
+    }
+};
+}
+#endif
+
+static size_t get_table_offset(size_t key_size) {
+    size_t key_words = (key_size * sizeof(int32_t) + sizeof(uint64_t) - 1) /
+        sizeof(uint64_t);
+    return (NUM_HEADER_WORDS + key_words) * sizeof(uint64_t);
+}
+
+static string get_cache_filename(
+    const string &cache_directory, const vector<int> &key) {
+    ostringstream filename;
+    filename << cache_directory << "/" << hex << setfill('0') << setw(16)
+             << utils::get_hash64(key) << ".pdb";
+    return filename.str();
+}
+
+bool is_cache_directory(const string &path) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    struct stat file_status;
+    return stat(path.c_str(), &file_status) == 0 &&
+           S_ISDIR(file_status.st_mode);
+#else
+    // Without stat, a missing directory only shows when writing fails.
+    return !path.empty();
+#endif
+}
+
+vector<int> compute_pdb_cache_key(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> variable_to_index(variables.size(), -1);
+    vector<int> key;
+    key.push_back(pattern.size());
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        variable_to_index[pattern[i]] = i;
+        key.push_back(variables[pattern[i]].get_domain_size());
+    }
+
+    vector<FactPair> facts;
+    auto add_projected_facts = [&]() {
+            key.push_back(facts.size());
+            for (const FactPair &fact : facts) {
+                key.push_back(fact.var);
+                key.push_back(fact.value);
+            }
+            facts.clear();
+        };
+    auto project = [&](FactProxy fact) {
+            int index = variable_to_index[fact.get_variable().get_id()];
+            if (index != -1)
+                facts.emplace_back(index, fact.get_value());
+        };
+
+    for (FactProxy goal : task_proxy.get_goals())
+        project(goal);
+    add_projected_facts();
+
+    // Operators without effects on the pattern do not affect the distances.
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (EffectProxy effect : op.get_effects())
+            project(effect.get_fact());
+        if (facts.empty())
+            continue;
+        vector<FactPair> effects;
+        swap(effects, facts);
+        key.push_back(operator_costs.empty() ?
+                      op.get_cost() : operator_costs[op.get_id()]);
+        for (FactProxy pre : op.get_preconditions())
+            project(pre);
+        add_projected_facts();
+        swap(effects, facts);
+        add_projected_facts();
+    }
+    return key;
+}
+
+bool load_cached_distances(
+    const string &cache_directory,
+    const vector<int> &key,
+    DistanceTable &distances) {
+    string filename = get_cache_filename(cache_directory, key);
+    ifstream file(filename, ios::binary);
+    uint64_t header[NUM_HEADER_WORDS];
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+        header[0] != MAGIC_NUMBER || header[1] != key.size())
+        return false;
+    vector<int32_t> file_key(key.size());
+    if (!file.read(reinterpret_cast<char *>(file_key.data()),
+                   file_key.size() * sizeof(int32_t)) ||
+        !equal(file_key.begin(), file_key.end(), key.begin()))
+        return false;
+
+    uint64_t bits_per_entry = header[2];
+    uint64_t num_entries = header[3];
+    if (bits_per_entry == 0 || bits_per_entry > 32 ||
+        (bits_per_entry & (bits_per_entry - 1)) ||
+        num_entries > static_cast<uint64_t>(numeric_limits<int>::max()))
+        return false;
+    uint64_t table_bytes = DistanceTable::get_num_words(
+        bits_per_entry, num_entries) * sizeof(uint64_t);
+    size_t table_offset = get_table_offset(key.size());
+    if (!file.seekg(0, ios::end) ||
+        static_cast<uint64_t>(file.tellg()) != table_offset + table_bytes)
+        return false;
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (table_bytes >= MIN_TABLE_BYTES_FOR_MAPPING) {
+        shared_ptr<MappedFile> mapped_file = make_shared<MappedFile>();
+        if (!mapped_file->map(filename))
+            return false;
+        distances = DistanceTable(
+            bits_per_entry, num_entries,
+            reinterpret_cast<const uint64_t *>(
+                mapped_file->get_data() + table_offset),
+            mapped_file);
+        return true;
+    }
+#endif
+    shared_ptr<vector<uint64_t>> words = make_shared<vector<uint64_t>>(
+        table_bytes / sizeof(uint64_t));
+    if (!file.seekg(table_offset) ||
+        !file.read(reinterpret_cast<char *>(words->data()), table_bytes))
+        return false;
+    distances = DistanceTable(
+        bits_per_entry, num_entries, words->data(), words);
+    return true;
+}
+
+bool store_cached_distances(
+    const string &cache_directory,
+    const vector<int> &key,
+    const DistanceTable &distances) {
+    uint64_t header[NUM_HEADER_WORDS] = {
+        MAGIC_NUMBER, key.size(),
+        static_cast<uint64_t>(distances.get_bits_per_entry()),
+        static_cast<uint64_t>(distances.size())};
+    vector<int32_t> padded_key(key.begin(), key.end());
+    padded_key.resize(
+        (get_table_offset(key.size()) - sizeof(header)) / sizeof(int32_t), 0);
+
+    // Concurrent writers of the same file each use their own temporary file.
+    static atomic<int> num_temporary_files(0);
+    string filename = get_cache_filename(cache_directory, key);
+    string temporary_filename =
+        filename + "." + to_string(utils::get_process_id()) + "." +
+        to_string(num_temporary_files++) + ".tmp";
+    ofstream file(temporary_filename, ios::binary);
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(padded_key.data()),
+               padded_key.size() * sizeof(int32_t));
+    file.write(reinterpret_cast<const char *>(distances.get_words()),
+               distances.get_num_words() * sizeof(uint64_t));
+    file.close();
+    if (file && rename(temporary_filename.c_str(), filename.c_str()) == 0)
+        return true;
+    remove(temporary_filename.c_str());
+    return false;
+}
+}
@@ -0,0 +1,57 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include <string>
+#include <vector>
+
+namespace pdbs {
+class DistanceTable;
+
+/*
+  Persistent cache for the distance tables of PDBs, which allows reusing
+  PDBs across planner runs, e.g., when solving the same task with several
+  configurations or tasks that share parts of their structure.
+
+  The distances of a PDB only depend on the projection of the task to the
+  pattern: the domains of the pattern variables, the goals on them and
+  the projected preconditions, effects and costs of the operators that
+  affect them. This projection is the key of the PDB in the cache, and a
+  64-bit hash of the key names its file in the cache directory. Since the
+  file also stores the full key, hash collisions are detected.
+
+  Large tables are memory-mapped, so loading does not copy them and pages
+  are only read from disk when they are accessed. Files are written
+  under a temporary name and renamed afterwards, so concurrent planner
+  runs can share a cache directory. Files are never removed.
+*/
+extern std::vector<int> compute_pdb_cache_key(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const std::vector<int> &operator_costs);
+
+// Return true iff the given path is an existing directory.
+extern bool is_cache_directory(const std::string &path);
+
+// Return true and set distances iff the cache contains the given key.
+extern bool load_cached_distances(
+    const std::string &cache_directory,
+    const std::vector<int> &key,
+    DistanceTable &distances);
+
+/*
+  Store the distances for the given key and return true iff this
+  succeeded. Failing to write the cache is not an error, and since PDBs
+  may be computed on several threads, this function does not log
+  anything. Callers report failures instead.
+*/
+extern bool store_cached_distances(
+    const std::string &cache_directory,
+    const std::vector<int> &key,
+    const DistanceTable &distances);
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "pattern_database.h"
 #include "pattern_generator.h"
+#include "utils.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -17,12 +18,16 @@ shared_ptr<PatternDatabase> get_pdb_from_options(const shared_ptr<AbstractTask>
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     PatternInformation pattern_info = pattern_generator->generate(task);
+    pattern_info.set_pdb_construction_options(
+        opts.get<bool>("symbolic"), get_pdb_cache_directory(opts));
     return pattern_info.get_pdb();
 }
 
 PDBHeuristic::PDBHeuristic(const Options &opts)
     : Heuristic(opts),
       pdb(get_pdb_from_options(task, opts)) {
+    log_pdb_cache_write_failures(
+        pdb->has_cache_write_failed(), get_pdb_cache_directory(opts), log);
 }
 
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -33,6 +38,12 @@ int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+bool PDBHeuristic::get_relevant_variables(set<int> &variables) const {
+    const Pattern &pattern = pdb->get_pattern();
+    variables.insert(pattern.begin(), pattern.end());
+    return true;
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Pattern database heuristic", "TODO");
     parser.document_language_support("action costs", "supported");
@@ -47,9 +58,12 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    add_symbolic_pdb_option_to_parser(parser);
+    add_pdb_cache_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
+    check_pdb_cache_option(parser, opts);
     if (parser.dry_run())
         return nullptr;
 
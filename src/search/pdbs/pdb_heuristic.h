@@ -27,6 +27,8 @@ public:
     */
     PDBHeuristic(const options::Options &opts);
     virtual ~PDBHeuristic() override = default;
+
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
 };
 }
 
@@ -0,0 +1,77 @@
+#include "pdb_lookup.h"
+
+#include "pattern_database.h"
+
+#include <map>
+
+using namespace std;
+
+namespace pdbs {
+PDBLookup::PDBLookup(const PDBCollection &pdb_collection) {
+    // Entries of each variable, ordered by PDB.
+    map<int, vector<pair<int, int>>> var_entries;
+    int num_pdbs = pdb_collection.size();
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id) {
+        const PatternDatabase &pdb = *pdb_collection[pdb_id];
+        pdbs.push_back(&pdb);
+        const Pattern &pattern = pdb.get_pattern();
+        const vector<int> &hash_multipliers = pdb.get_hash_multipliers();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            // Symbolic PDBs only need to know which variables changed.
+            int multiplier = pdb.is_symbolic() ? 0 : hash_multipliers[i];
+            var_entries[pattern[i]].emplace_back(pdb_id, multiplier);
+        }
+    }
+
+    row_starts.push_back(0);
+    for (const auto &entry : var_entries) {
+        vars.push_back(entry.first);
+        for (const pair<int, int> &pdb_and_multiplier : entry.second) {
+            entry_pdb_ids.push_back(pdb_and_multiplier.first);
+            entry_multipliers.push_back(pdb_and_multiplier.second);
+        }
+        row_starts.push_back(entry_pdb_ids.size());
+    }
+
+    // Start with the state in which all variables have value 0.
+    vector<int> state(vars.empty() ? 0 : vars.back() + 1, 0);
+    state_values.assign(vars.size(), 0);
+    indices.assign(num_pdbs, 0);
+    for (const PatternDatabase *pdb : pdbs) {
+        if (pdb->is_symbolic())
+            values.push_back(pdb->get_value(state));
+        else
+            values.push_back(pdb->get_value_for_index(0));
+    }
+    is_changed.assign(num_pdbs, false);
+}
+
+const vector<int> &PDBLookup::compute_values(const vector<int> &state) const {
+    int num_vars = vars.size();
+    for (int i = 0; i < num_vars; ++i) {
+        int value = state[vars[i]];
+        int difference = value - state_values[i];
+        if (difference == 0)
+            continue;
+        state_values[i] = value;
+        for (int entry = row_starts[i]; entry < row_starts[i + 1]; ++entry) {
+            int pdb_id = entry_pdb_ids[entry];
+            indices[pdb_id] += difference * entry_multipliers[entry];
+            if (!is_changed[pdb_id]) {
+                is_changed[pdb_id] = true;
+                changed_pdb_ids.push_back(pdb_id);
+            }
+        }
+    }
+    for (int pdb_id : changed_pdb_ids) {
+        is_changed[pdb_id] = false;
+        const PatternDatabase &pdb = *pdbs[pdb_id];
+        if (pdb.is_symbolic())
+            values[pdb_id] = pdb.get_value(state);
+        else
+            values[pdb_id] = pdb.get_value_for_index(indices[pdb_id]);
+    }
+    changed_pdb_ids.clear();
+    return values;
+}
+}
@@ -0,0 +1,60 @@
+#ifndef PDBS_PDB_LOOKUP_H
+#define PDBS_PDB_LOOKUP_H
+
+#include "types.h"
+
+#include <vector>
+
+namespace pdbs {
+/*
+  Looks up the values of all PDBs of a collection for a state at once.
+  Instead of computing the index of each PDB separately from its pattern,
+  a var-major table stores for each variable its multipliers in all PDBs
+  whose patterns contain it. The table is sparse because most variables
+  only occur in a few patterns of a collection.
+
+  The lookup keeps the indices and values of the PDBs for the previous
+  state. The index of a PDB only changes by multiplier * (new - old) for
+  each of its variables whose value changed, so a lookup only visits the
+  table rows of the changed variables and only looks up the distances of
+  the PDBs whose index changed. Consecutively evaluated states usually
+  differ in a few variables (e.g., siblings in eager search only differ
+  in the effects of their operators), which makes the cost of a lookup
+  proportional to the changes rather than to the pattern sizes.
+
+  Symbolic PDBs have no indices and are looked up with the full state if
+  one of their variables changed. The PDBs are not owned by the lookup
+  and must outlive it. Since the lookup updates its cache, it is not
+  thread-safe.
+*/
+class PDBLookup {
+    std::vector<const PatternDatabase *> pdbs;
+    // Variables that occur in some pattern.
+    std::vector<int> vars;
+    // The entries of vars[i] are the ones in [row_starts[i], row_starts[i + 1]).
+    std::vector<int> row_starts;
+    std::vector<int> entry_pdb_ids;
+    std::vector<int> entry_multipliers;
+
+    /*
+      The values of vars in the previous state and the resulting indices
+      and values of the PDBs. They only cache the previous lookup and are
+      therefore mutable.
+    */
+    mutable std::vector<int> state_values;
+    mutable std::vector<int> indices;
+    mutable std::vector<int> values;
+    mutable std::vector<int> changed_pdb_ids;
+    mutable std::vector<bool> is_changed;
+public:
+    explicit PDBLookup(const PDBCollection &pdbs);
+
+    /*
+      Return the values of all PDBs for the given state. The result is
+      valid until the next call.
+    */
+    const std::vector<int> &compute_values(const std::vector<int> &state) const;
+};
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include "saturated_cost_partitioning.h"
+
+#include "pattern_database.h"
+#include "utils.h"
+
+#include "../task_proxy.h"
+
+#include "../task_utils/sampling.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/rng.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+
+namespace pdbs {
+static const int INF = numeric_limits<int>::max();
+
+// Dead ends count as positive values.
+static bool has_positive_value(const PatternDatabase &pdb) {
+    int num_states = pdb.get_size();
+    for (int index = 0; index < num_states; ++index) {
+        if (pdb.get_value_for_index(index) != 0)
+            return true;
+    }
+    return false;
+}
+
+// Return the sum of the PDB values or INF if one of them is INF.
+static int compute_sum(const PDBCollection &pdbs, const vector<int> &state) {
+    int sum = 0;
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        int h = pdb->get_value(state);
+        if (h == INF)
+            return INF;
+        sum += h;
+    }
+    return sum;
+}
+
+static shared_ptr<PatternDatabase> compute_explicit_pdb(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs, const string &cache_directory,
+    int &num_cache_write_failures) {
+    shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
+        task_proxy, pattern, operator_costs, false, nullptr, false, false,
+        cache_directory);
+    if (pdb->has_cache_write_failed())
+        ++num_cache_write_failures;
+    return pdb;
+}
+
+SaturatedCostPartitioning::SaturatedCostPartitioning(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    const PDBCollection &full_cost_pdbs,
+    int max_orders,
+    double max_time,
+    bool diversify,
+    int num_samples,
+    utils::RandomNumberGenerator &rng,
+    const string &cache_directory,
+    utils::LogProxy &log) {
+    utils::CountdownTimer timer(max_time);
+    int num_patterns = patterns.size();
+    assert(full_cost_pdbs.size() == patterns.size());
+    vector<int> operator_costs;
+    for (OperatorProxy op : task_proxy.get_operators())
+        operator_costs.push_back(op.get_cost());
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    const vector<int> &initial_values = initial_state.get_unpacked_values();
+    int num_cache_write_failures = 0;
+
+    /*
+      The PDB of the first pattern of an order uses the full costs, so we
+      compute the saturated costs for the full costs only once. We order
+      the patterns greedily by the ratio of their initial state value and
+      the total costs they need.
+    */
+    PDBCollection explicit_full_cost_pdbs;
+    // Only the operators with positive saturated costs, as (op_id, cost).
+    vector<vector<pair<int, int>>> full_saturated_costs(num_patterns);
+    vector<double> scores;
+    for (int pattern_id = 0; pattern_id < num_patterns; ++pattern_id) {
+        shared_ptr<PatternDatabase> pdb = full_cost_pdbs[pattern_id];
+        if (pdb->is_symbolic()) {
+            pdb = compute_explicit_pdb(
+                task_proxy, patterns[pattern_id], operator_costs,
+                cache_directory, num_cache_write_failures);
+        }
+        vector<int> saturated_costs = pdb->compute_saturated_costs(task_proxy);
+        int64_t total_saturated_costs = 0;
+        for (size_t op_id = 0; op_id < saturated_costs.size(); ++op_id) {
+            if (saturated_costs[op_id] != 0) {
+                full_saturated_costs[pattern_id].emplace_back(
+                    op_id, saturated_costs[op_id]);
+                total_saturated_costs += saturated_costs[op_id];
+            }
+        }
+        int init_h = pdb->get_value(initial_values);
+        if (init_h == INF)
+            scores.push_back(numeric_limits<double>::infinity());
+        else
+            scores.push_back(init_h / (1.0 + total_saturated_costs));
+        explicit_full_cost_pdbs.push_back(move(pdb));
+    }
+    vector<int> order(num_patterns);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int p1, int p2) {
+                    return scores[p1] > scores[p2];
+                });
+
+    /*
+      Compute the PDBs of the saturated cost partitioning for the given
+      order. Return false if the time limit is reached before and
+      abort_on_timeout is true.
+    */
+    auto compute_order_pdbs = [&](PDBCollection &order_pdbs,
+                                  bool abort_on_timeout) {
+            vector<int> remaining_costs = operator_costs;
+            bool has_full_costs = true;
+            for (int pattern_id : order) {
+                if (abort_on_timeout && timer.is_expired())
+                    return false;
+                shared_ptr<PatternDatabase> pdb;
+                if (has_full_costs) {
+                    pdb = explicit_full_cost_pdbs[pattern_id];
+                    for (const pair<int, int> &op_and_cost :
+                         full_saturated_costs[pattern_id]) {
+                        remaining_costs[op_and_cost.first] -= op_and_cost.second;
+                        has_full_costs = false;
+                    }
+                } else {
+                    pdb = compute_explicit_pdb(
+                        task_proxy, patterns[pattern_id], remaining_costs,
+                        cache_directory, num_cache_write_failures);
+                    vector<int> saturated_costs = pdb->compute_saturated_costs(
+                        task_proxy, remaining_costs);
+                    for (size_t op_id = 0; op_id < remaining_costs.size(); ++op_id) {
+                        assert(saturated_costs[op_id] <= remaining_costs[op_id]);
+                        remaining_costs[op_id] -= saturated_costs[op_id];
+                    }
+                }
+                if (has_positive_value(*pdb))
+                    order_pdbs.push_back(move(pdb));
+            }
+            return true;
+        };
+    auto add_order = [&](PDBCollection &order_pdbs) {
+            order_starts.push_back(pdbs.size());
+            move(order_pdbs.begin(), order_pdbs.end(), back_inserter(pdbs));
+        };
+
+    PDBCollection first_order_pdbs;
+    compute_order_pdbs(first_order_pdbs, false);
+    int init_h = compute_sum(first_order_pdbs, initial_values);
+
+    vector<State> samples;
+    vector<int> sample_h_values;
+    if (diversify && max_orders > 1 && init_h != INF) {
+        sampling::RandomWalkSampler sampler(task_proxy, rng);
+        auto is_dead_end = [&](const State &state) {
+                state.unpack();
+                return compute_sum(first_order_pdbs, state.get_unpacked_values())
+                       == INF;
+            };
+        for (int i = 0; i < num_samples; ++i) {
+            samples.push_back(sampler.sample_state(init_h, is_dead_end));
+            samples.back().unpack();
+            sample_h_values.push_back(
+                compute_sum(first_order_pdbs, samples.back().get_unpacked_values()));
+        }
+    }
+    add_order(first_order_pdbs);
+
+    /*
+      All orders detect the same dead ends, so if the initial state is a
+      dead end, more orders cannot help.
+    */
+    int num_computed_orders = 1;
+    while (init_h != INF && num_computed_orders < max_orders &&
+           !timer.is_expired()) {
+        rng.shuffle(order);
+        PDBCollection order_pdbs;
+        if (!compute_order_pdbs(order_pdbs, true))
+            break;
+        ++num_computed_orders;
+        bool is_useful = !diversify;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            int h = compute_sum(order_pdbs, samples[i].get_unpacked_values());
+            if (h > sample_h_values[i]) {
+                sample_h_values[i] = h;
+                is_useful = true;
+            }
+        }
+        if (is_useful)
+            add_order(order_pdbs);
+    }
+    order_starts.push_back(pdbs.size());
+    lookup = utils::make_unique_ptr<PDBLookup>(pdbs);
+    log_pdb_cache_write_failures(num_cache_write_failures, cache_directory, log);
+
+    if (log.is_at_least_normal()) {
+        int64_t total_size = 0;
+        for (const shared_ptr<PatternDatabase> &pdb : pdbs)
+            total_size += pdb->get_size();
+        log << "Saturated cost partitioning orders: " << get_num_orders()
+            << " of " << num_computed_orders << " computed" << endl;
+        log << "Saturated cost partitioning PDBs: " << pdbs.size() << endl;
+        log << "Saturated cost partitioning total PDB size: " << total_size
+            << endl;
+        log << "Saturated cost partitioning initial h value: "
+            << get_value(initial_state) << endl;
+        log << "Saturated cost partitioning computation time: "
+            << timer.get_elapsed_time() << endl;
+    }
+}
+
+int SaturatedCostPartitioning::get_value(const State &state) const {
+    state.unpack();
+    const vector<int> &values = lookup->compute_values(state.get_unpacked_values());
+    int max_h = 0;
+    int num_orders = get_num_orders();
+    for (int order_id = 0; order_id < num_orders; ++order_id) {
+        int h = 0;
+        for (int i = order_starts[order_id]; i < order_starts[order_id + 1]; ++i) {
+            if (values[i] == INF)
+                return INF;
+            h += values[i];
+        }
+        max_h = max(max_h, h);
+    }
+    return max_h;
+}
+}
@@ -0,0 +1,79 @@
+#ifndef PDBS_SATURATED_COST_PARTITIONING_H
+#define PDBS_SATURATED_COST_PARTITIONING_H
+
+#include "pdb_lookup.h"
+#include "types.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class State;
+class TaskProxy;
+
+namespace utils {
+class LogProxy;
+class RandomNumberGenerator;
+}
+
+namespace pdbs {
+/*
+  Saturated cost partitioning over the PDBs of a pattern collection.
+
+  For an order of the patterns, the PDB of each pattern is computed with
+  the operator costs that the PDBs of the previous patterns left over. It
+  only uses its saturated costs (see
+  PatternDatabase::compute_saturated_costs), and the remaining costs are
+  left for the next PDB. The sum of the PDB values for an order is
+  admissible, and so is the maximum over several orders.
+
+  The first order is greedy: it prefers patterns with high values for the
+  initial state that need little of the costs. All further orders are
+  random. At most max_orders orders are computed, and computing further
+  orders stops when max_time is reached, but the first order is always
+  completed. If diversify is true, a random order is only kept if it
+  yields a higher value than all kept orders for at least one of
+  num_samples states sampled with random walks; otherwise all orders are
+  kept.
+
+  PDBs whose values are all 0 are dropped. The PDBs of all orders are
+  looked up together with one PDBLookup, so evaluating a state visits
+  each changed variable only once for all orders.
+*/
+class SaturatedCostPartitioning {
+    // The PDBs of order i are pdbs[order_starts[i], order_starts[i + 1]).
+    PDBCollection pdbs;
+    std::vector<int> order_starts;
+    std::unique_ptr<PDBLookup> lookup;
+public:
+    /*
+      full_cost_pdbs must contain a PDB for each pattern, computed with the
+      operator costs of the task. Symbolic PDBs in it are recomputed as
+      explicit PDBs. The PDBs are loaded from and stored in the PDB cache
+      in cache_directory unless it is empty (see pdb_cache.h).
+    */
+    SaturatedCostPartitioning(
+        const TaskProxy &task_proxy,
+        const PatternCollection &patterns,
+        const PDBCollection &full_cost_pdbs,
+        int max_orders,
+        double max_time,
+        bool diversify,
+        int num_samples,
+        utils::RandomNumberGenerator &rng,
+        const std::string &cache_directory,
+        utils::LogProxy &log);
+
+    int get_value(const State &state) const;
+
+    const PDBCollection &get_pattern_databases() const {
+        return pdbs;
+    }
+
+    int get_num_orders() const {
+        return order_starts.size() - 1;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include "saturated_cost_partitioning_heuristic.h"
+
+#include "pattern_database.h"
+#include "pattern_generator.h"
+#include "utils.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/markup.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/timer.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace pdbs {
+static SaturatedCostPartitioning get_scp_from_options(
+    const shared_ptr<AbstractTask> &task, const Options &opts,
+    utils::LogProxy &log) {
+    utils::Timer timer;
+    if (log.is_at_least_normal()) {
+        log << "Initializing saturated cost partitioning PDB heuristic..."
+            << endl;
+    }
+    shared_ptr<PatternCollectionGenerator> pattern_generator =
+        opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
+    PatternCollectionInformation pattern_collection_info =
+        pattern_generator->generate(task);
+    string cache_directory = get_pdb_cache_directory(opts);
+    pattern_collection_info.set_pdb_construction_options(
+        1, numeric_limits<int>::max(), false, cache_directory);
+    shared_ptr<utils::RandomNumberGenerator> rng =
+        utils::parse_rng_from_options(opts);
+    TaskProxy task_proxy(*task);
+    SaturatedCostPartitioning scp(
+        task_proxy, *pattern_collection_info.get_patterns(),
+        *pattern_collection_info.get_pdbs(), opts.get<int>("max_orders"),
+        opts.get<double>("max_time"), opts.get<bool>("diversify"),
+        opts.get<int>("samples"), *rng, cache_directory, log);
+    if (log.is_at_least_normal()) {
+        log << "Saturated cost partitioning PDB heuristic computation time: "
+            << timer << endl;
+    }
+    return scp;
+}
+
+SaturatedCostPartitioningHeuristic::SaturatedCostPartitioningHeuristic(
+    const Options &opts)
+    : Heuristic(opts),
+      scp(get_scp_from_options(task, opts, log)) {
+}
+
+int SaturatedCostPartitioningHeuristic::compute_heuristic(
+    const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    int h = scp.get_value(state);
+    if (h == numeric_limits<int>::max())
+        return DEAD_END;
+    return h;
+}
+
+bool SaturatedCostPartitioningHeuristic::get_relevant_variables(
+    set<int> &variables) const {
+    for (const shared_ptr<PatternDatabase> &pdb : scp.get_pattern_databases()) {
+        const Pattern &pattern = pdb->get_pattern();
+        variables.insert(pattern.begin(), pattern.end());
+    }
+    return true;
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Saturated cost partitioning PDB",
+        "Maximum over saturated cost partitionings of the PDBs of a pattern "
+        "collection for several orders of the patterns. For an order, each "
+        "PDB is computed with the operator costs left over by the previous "
+        "PDBs and only uses the costs it needs to preserve all of its goal "
+        "distances. The first order greedily prefers patterns with high "
+        "initial state values that need little of the costs, all further "
+        "orders are random. For details, see" +
+        utils::format_journal_reference(
+            {"Jendrik Seipp", "Thomas Keller", "Malte Helmert"},
+            "Saturated Cost Partitioning for Optimal Classical Planning",
+            "https://ai.dmi.unibas.ch/papers/seipp-et-al-jair2020.pdf",
+            "Journal of Artificial Intelligence Research",
+            "67",
+            "129-167",
+            "2020"));
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.document_property("admissible", "yes");
+    parser.document_property("consistent", "yes");
+    parser.document_property("safe", "yes");
+    parser.document_property("preferred operators", "no");
+
+    parser.add_option<shared_ptr<PatternCollectionGenerator>>(
+        "patterns",
+        "pattern generation method",
+        "systematic(2)");
+    parser.add_option<int>(
+        "max_orders",
+        "maximum number of orders for which the cost partitioning is computed",
+        "100",
+        Bounds("1", "infinity"));
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for computing orders. The first order is "
+        "always computed completely.",
+        "10.0",
+        Bounds("0.0", "infinity"));
+    parser.add_option<bool>(
+        "diversify",
+        "only keep an order if it yields a higher heuristic value than all "
+        "previously kept orders for one of the sample states",
+        "true");
+    parser.add_option<int>(
+        "samples",
+        "number of states sampled with random walks for diversification",
+        "1000",
+        Bounds("1", "infinity"));
+    add_pdb_cache_option_to_parser(parser);
+    utils::add_rng_options(parser);
+    Heuristic::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    check_pdb_cache_option(parser, opts);
+    if (parser.dry_run())
+        return nullptr;
+
+    return make_shared<SaturatedCostPartitioningHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("scpdbs", _parse, "heuristics_pdb");
+}
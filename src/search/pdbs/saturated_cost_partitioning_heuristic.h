@@ -0,0 +1,21 @@
+#ifndef PDBS_SATURATED_COST_PARTITIONING_HEURISTIC_H
+#define PDBS_SATURATED_COST_PARTITIONING_HEURISTIC_H
+
+#include "saturated_cost_partitioning.h"
+
+#include "../heuristic.h"
+
+namespace pdbs {
+class SaturatedCostPartitioningHeuristic : public Heuristic {
+    SaturatedCostPartitioning scp;
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+public:
+    explicit SaturatedCostPartitioningHeuristic(const options::Options &opts);
+    virtual ~SaturatedCostPartitioningHeuristic() = default;
+
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
+};
+}
+
+#endif
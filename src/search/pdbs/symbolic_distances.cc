@@ -0,0 +1,230 @@
+#include "symbolic_distances.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+
+using namespace std;
+using decision_diagrams::Manager;
+using decision_diagrams::NodeID;
+
+namespace pdbs {
+/*
+  Garbage is collected when the number of nodes has doubled since the
+  last collection, but not for small managers.
+*/
+static const int MIN_NODES_FOR_GARBAGE_COLLECTION = 1 << 18;
+
+/*
+  The operators with the same cost and the same effects on the pattern
+  variables. The precondition is the disjunction of their preconditions.
+*/
+struct SymbolicOperator {
+    int cost;
+    NodeID precondition;
+    NodeID effect;
+    // Cube of the BDD variables of the variables with an effect.
+    NodeID effect_vars;
+
+    SymbolicOperator(int cost, NodeID precondition, NodeID effect,
+                     NodeID effect_vars)
+        : cost(cost),
+          precondition(precondition),
+          effect(effect),
+          effect_vars(effect_vars) {
+    }
+};
+
+SymbolicDistances::SymbolicDistances(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> variable_to_index(variables.size(), -1);
+    // The BDD variables of a pattern variable, most significant bit first.
+    vector<vector<int>> var_bits(pattern.size());
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        variable_to_index[pattern[i]] = i;
+        int domain_size = variables[pattern[i]].get_domain_size();
+        int num_bits = 0;
+        while ((1 << num_bits) < domain_size)
+            ++num_bits;
+        for (int bit = num_bits - 1; bit >= 0; --bit) {
+            var_bits[i].push_back(bit_vars.size());
+            bit_vars.push_back(pattern[i]);
+            bit_shifts.push_back(bit);
+        }
+    }
+
+    Manager manager(bit_vars.size());
+    auto make_fact = [&](int index, int value) {
+            NodeID fact = Manager::BDD_TRUE;
+            for (auto it = var_bits[index].rbegin();
+                 it != var_bits[index].rend(); ++it) {
+                if ((value >> bit_shifts[*it]) & 1)
+                    fact = manager.make_node(*it, Manager::BDD_FALSE, fact);
+                else
+                    fact = manager.make_node(*it, fact, Manager::BDD_FALSE);
+            }
+            return fact;
+        };
+    // Binary codes beyond the domain do not represent abstract states.
+    vector<NodeID> valid_values;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        NodeID valid = Manager::BDD_FALSE;
+        int domain_size = variables[pattern[i]].get_domain_size();
+        for (int value = 0; value < domain_size; ++value)
+            valid = manager.bdd_or(valid, make_fact(i, value));
+        valid_values.push_back(valid);
+    }
+
+    vector<SymbolicOperator> operators;
+    map<pair<int, vector<FactPair>>, int> operator_ids;
+    bool has_zero_cost_operators = false;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        vector<FactPair> effects;
+        for (EffectProxy eff : op.get_effects()) {
+            int index = variable_to_index[eff.get_fact().get_variable().get_id()];
+            if (index != -1)
+                effects.emplace_back(index, eff.get_fact().get_value());
+        }
+        if (effects.empty())
+            continue;
+        sort(effects.begin(), effects.end());
+
+        /*
+          A regression step forgets the values of the variables with an
+          effect, so their values in a predecessor are only restricted by
+          the preconditions of the operator.
+        */
+        NodeID precondition = Manager::BDD_TRUE;
+        vector<bool> has_precondition(pattern.size(), false);
+        for (FactProxy pre : op.get_preconditions()) {
+            int index = variable_to_index[pre.get_variable().get_id()];
+            if (index != -1) {
+                has_precondition[index] = true;
+                precondition = manager.bdd_and(
+                    precondition, make_fact(index, pre.get_value()));
+            }
+        }
+        for (const FactPair &eff : effects) {
+            if (!has_precondition[eff.var])
+                precondition = manager.bdd_and(
+                    precondition, valid_values[eff.var]);
+        }
+
+        int cost = operator_costs.empty() ?
+            op.get_cost() : operator_costs[op.get_id()];
+        has_zero_cost_operators |= (cost == 0);
+        auto key = make_pair(cost, effects);
+        auto it = operator_ids.find(key);
+        if (it != operator_ids.end()) {
+            NodeID &group_precondition = operators[it->second].precondition;
+            group_precondition = manager.bdd_or(group_precondition, precondition);
+            continue;
+        }
+        NodeID effect = Manager::BDD_TRUE;
+        vector<int> effect_bits;
+        for (const FactPair &eff : effects) {
+            effect = manager.bdd_and(effect, make_fact(eff.var, eff.value));
+            effect_bits.insert(effect_bits.end(), var_bits[eff.var].begin(),
+                               var_bits[eff.var].end());
+        }
+        operator_ids[key] = operators.size();
+        operators.emplace_back(
+            cost, precondition, effect, manager.make_cube(effect_bits));
+    }
+
+    NodeID goal = Manager::BDD_TRUE;
+    for (NodeID valid : valid_values)
+        goal = manager.bdd_and(goal, valid);
+    for (FactProxy fact : task_proxy.get_goals()) {
+        int index = variable_to_index[fact.get_variable().get_id()];
+        if (index != -1)
+            goal = manager.bdd_and(goal, make_fact(index, fact.get_value()));
+    }
+
+    auto regress = [&](NodeID states, const SymbolicOperator &op) {
+            return manager.bdd_and(
+                op.precondition,
+                manager.bdd_and_exists(states, op.effect, op.effect_vars));
+        };
+
+    // Symbolic Dijkstra search over sets of states with the same distance.
+    map<int, NodeID> open;
+    open[0] = goal;
+    NodeID closed = Manager::BDD_FALSE;
+    vector<pair<int, NodeID>> layers;
+    int num_nodes_after_collection = manager.get_num_nodes();
+    while (!open.empty()) {
+        int distance = open.begin()->first;
+        NodeID layer = manager.bdd_and_not(open.begin()->second, closed);
+        open.erase(open.begin());
+        if (layer == Manager::BDD_FALSE)
+            continue;
+
+        if (has_zero_cost_operators) {
+            NodeID frontier = layer;
+            while (frontier != Manager::BDD_FALSE) {
+                NodeID predecessors = Manager::BDD_FALSE;
+                for (const SymbolicOperator &op : operators) {
+                    if (op.cost == 0)
+                        predecessors = manager.bdd_or(
+                            predecessors, regress(frontier, op));
+                }
+                frontier = manager.bdd_and_not(
+                    manager.bdd_and_not(predecessors, closed), layer);
+                layer = manager.bdd_or(layer, frontier);
+            }
+        }
+        closed = manager.bdd_or(closed, layer);
+        layers.emplace_back(distance, layer);
+
+        for (const SymbolicOperator &op : operators) {
+            if (op.cost == 0)
+                continue;
+            NodeID predecessors = regress(layer, op);
+            if (predecessors == Manager::BDD_FALSE)
+                continue;
+            auto inserted = open.emplace(distance + op.cost, predecessors);
+            if (!inserted.second) {
+                NodeID &states = inserted.first->second;
+                states = manager.bdd_or(states, predecessors);
+            }
+        }
+
+        if (manager.get_num_nodes() >= MIN_NODES_FOR_GARBAGE_COLLECTION &&
+            manager.get_num_nodes() >= 2 * num_nodes_after_collection) {
+            vector<NodeID *> roots = {&closed};
+            for (SymbolicOperator &op : operators) {
+                roots.push_back(&op.precondition);
+                roots.push_back(&op.effect);
+                roots.push_back(&op.effect_vars);
+            }
+            for (auto &entry : open)
+                roots.push_back(&entry.second);
+            for (auto &entry : layers)
+                roots.push_back(&entry.second);
+            manager.collect_garbage(roots);
+            num_nodes_after_collection = manager.get_num_nodes();
+        }
+    }
+
+    NodeID distances = manager.make_terminal(numeric_limits<int>::max());
+    double sum = 0;
+    double num_finite_states = 0;
+    for (const pair<int, NodeID> &entry : layers) {
+        distances = manager.add_ite_terminal(entry.second, entry.first, distances);
+        double num_states = manager.count_models(entry.second);
+        sum += entry.first * num_states;
+        num_finite_states += num_states;
+    }
+    if (num_finite_states == 0) // All states are dead ends.
+        mean_finite_h = numeric_limits<double>::infinity();
+    else
+        mean_finite_h = sum / num_finite_states;
+    num_layers = layers.size();
+    nodes = manager.extract(distances);
+}
+}
@@ -0,0 +1,78 @@
+#ifndef PDBS_SYMBOLIC_DISTANCES_H
+#define PDBS_SYMBOLIC_DISTANCES_H
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include "../algorithms/decision_diagrams.h"
+
+#include <vector>
+
+namespace pdbs {
+/*
+  Computes the goal distances of the abstract states of a pattern with a
+  symbolic regression search and stores them as a decision diagram.
+
+  Every pattern variable is encoded in binary by as many BDD variables as
+  its domain needs, ordered like the pattern. The search is a symbolic
+  version of Dijkstra's algorithm: it expands the states with the same
+  distance together, computing their predecessors under all operators of
+  the same cost with one image computation per operator effect (operators
+  with equal projected effects and costs share their preconditions). The
+  states of each distance layer are stored as a BDD. At the end, the layers
+  are combined into an algebraic decision diagram that maps each abstract
+  state to its goal distance. A lookup follows one path from its root,
+  which takes at most one step per BDD variable.
+
+  For tasks with structure, the decision diagrams are often much smaller
+  than explicit tables, which allows using patterns with more abstract
+  states.
+*/
+class SymbolicDistances {
+    // For each BDD variable, the task variable it encodes and the bit.
+    std::vector<int> bit_vars;
+    std::vector<int> bit_shifts;
+    // Distance diagram with the root at index 0.
+    std::vector<decision_diagrams::Node> nodes;
+    int num_layers;
+    double mean_finite_h;
+public:
+    /*
+      operator_costs can specify individual costs for each operator. If
+      left empty, the costs of the task are used.
+    */
+    SymbolicDistances(
+        const TaskProxy &task_proxy,
+        const Pattern &pattern,
+        const std::vector<int> &operator_costs);
+
+    int get_value(const std::vector<int> &state) const {
+        int num_bits = bit_vars.size();
+        int index = 0;
+        while (nodes[index].var != num_bits) {
+            const decision_diagrams::Node &node = nodes[index];
+            if ((state[bit_vars[node.var]] >> bit_shifts[node.var]) & 1)
+                index = node.high;
+            else
+                index = node.low;
+        }
+        return nodes[index].low;
+    }
+
+    int get_num_nodes() const {
+        return nodes.size();
+    }
+
+    int get_num_layers() const {
+        return num_layers;
+    }
+
+    // See PatternDatabase::compute_mean_finite_h().
+    double get_mean_finite_h() const {
+        return mean_finite_h;
+    }
+};
+}
+
+#endif
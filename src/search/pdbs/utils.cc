@@ -3,7 +3,9 @@
 #include "pattern_collection_information.h"
 #include "pattern_database.h"
 #include "pattern_information.h"
+#include "pdb_cache.h"
 
+#include "../option_parser.h"
 #include "../task_proxy.h"
 
 #include "../task_utils/causal_graph.h"
@@ -12,9 +14,15 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
 
 using namespace std;
 
@@ -132,6 +140,141 @@ void dump_pattern_collection_generation_statistics(
     }
 }
 
+shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads,
+    int max_concurrent_states,
+    bool symbolic,
+    const string &cache_directory,
+    utils::LogProxy &log,
+    const function<vector<int>(int)> &get_operator_costs) {
+    int num_patterns = patterns.size();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>(num_patterns);
+    vector<double> construction_times(num_patterns);
+
+    mutex budget_mutex;
+    condition_variable budget_released;
+    int64_t states_under_construction = 0;
+
+    utils::parallel_for(num_patterns, num_threads, [&](int pattern_id) {
+            const Pattern &pattern = patterns[pattern_id];
+            int pdb_size = compute_pdb_size(task_proxy, pattern);
+            {
+                unique_lock<mutex> lock(budget_mutex);
+                budget_released.wait(lock, [&]() {
+                        return states_under_construction == 0 ||
+                        states_under_construction + pdb_size <= max_concurrent_states;
+                    });
+                states_under_construction += pdb_size;
+            }
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            vector<int> operator_costs;
+            if (get_operator_costs)
+                operator_costs = get_operator_costs(pattern_id);
+            (*pdbs)[pattern_id] = make_shared<PatternDatabase>(
+                task_proxy, pattern, operator_costs, false, nullptr, false,
+                symbolic, cache_directory);
+            construction_times[pattern_id] = chrono::duration<double>(
+                chrono::steady_clock::now() - start).count();
+
+            {
+                lock_guard<mutex> lock(budget_mutex);
+                states_under_construction -= pdb_size;
+            }
+            budget_released.notify_all();
+        });
+
+    if (log.is_at_least_verbose()) {
+        for (int pattern_id = 0; pattern_id < num_patterns; ++pattern_id) {
+            log << "PDB for pattern " << patterns[pattern_id] << ": "
+                << (*pdbs)[pattern_id]->get_size() << " abstract states, "
+                << "computed in "
+                << utils::Duration(construction_times[pattern_id]) << endl;
+        }
+    }
+    int num_cache_write_failures = count_if(
+        pdbs->begin(), pdbs->end(), [](const shared_ptr<PatternDatabase> &pdb) {
+            return pdb->has_cache_write_failed();
+        });
+    log_pdb_cache_write_failures(num_cache_write_failures, cache_directory, log);
+    return pdbs;
+}
+
+void add_symbolic_pdb_option_to_parser(options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "symbolic",
+        "compute the PDBs with a symbolic search and store their distances "
+        "as decision diagrams instead of explicit tables. For tasks with "
+        "structure, this needs much less memory and allows using larger "
+        "patterns, but lookups are slower. The number of abstract states "
+        "of a PDB must still be below 2^31.",
+        "false");
+}
+
+void add_pdb_cache_option_to_parser(options::OptionParser &parser) {
+    parser.add_option<string>(
+        "cache_directory",
+        "directory of a persistent cache for the distance tables of explicit "
+        "PDBs, or 'none' to disable caching. A PDB is loaded from the cache "
+        "if the cache contains a PDB for the same projection of the task "
+        "to the pattern, including the operator costs, and stored in the "
+        "cache otherwise. Large PDBs are memory-mapped when they are loaded. "
+        "The directory must "
+        "exist. Note that the configuration is converted to lower case.",
+        "none");
+}
+
+void check_pdb_cache_option(
+    options::OptionParser &parser, const options::Options &opts) {
+    if (parser.help_mode())
+        return;
+    string cache_directory = get_pdb_cache_directory(opts);
+    if (!cache_directory.empty() && !is_cache_directory(cache_directory))
+        parser.error("PDB cache directory " + cache_directory +
+                     " does not exist");
+}
+
+string get_pdb_cache_directory(const options::Options &opts) {
+    string cache_directory = opts.get<string>("cache_directory");
+    if (cache_directory == "none")
+        return string();
+    return cache_directory;
+}
+
+void log_pdb_cache_write_failures(
+    int num_failures, const string &cache_directory, utils::LogProxy &log) {
+    // Pattern generators compute PDBs many times, so we only warn once.
+    static bool has_warned = false;
+    if (num_failures > 0 && !has_warned && log.is_warning()) {
+        log << "Warning: could not store " << num_failures
+            << " PDB(s) in the PDB cache directory " << cache_directory
+            << ". Further failures are not reported." << endl;
+        has_warned = true;
+    }
+}
+
+void add_pdb_construction_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads used to compute independent PDBs concurrently. "
+        "Note that every additional thread reserves address space for its "
+        "own memory allocations, which counts towards address space limits "
+        "and the reported peak memory.",
+        "1",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_concurrent_states",
+        "maximum total number of abstract states of the PDBs that are "
+        "computed concurrently, which bounds the memory needed for "
+        "concurrent construction (a larger PDB is computed on its own)",
+        "infinity",
+        Bounds("1", "infinity"));
+    add_symbolic_pdb_option_to_parser(parser);
+    add_pdb_cache_option_to_parser(parser);
+}
+
 string get_rovner_et_al_reference() {
     return utils::format_conference_reference(
         {"Alexander Rovner", "Silvan Sievers", "Malte Helmert"},
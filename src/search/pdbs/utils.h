@@ -7,8 +7,15 @@
 
 #include "../utils/timer.h"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
 
 namespace utils {
 class LogProxy;
@@ -64,6 +71,50 @@ extern void dump_pattern_collection_generation_statistics(
     const PatternCollectionInformation &pci,
     utils::LogProxy &log);
 
+/*
+  Compute the PDBs for the given patterns on up to num_threads threads.
+  If get_operator_costs is given, it returns the operator costs for the
+  pattern with the given index; otherwise the costs of the task are used.
+  To bound the memory used for construction, PDBs are only built
+  concurrently as long as the total number of abstract states of the PDBs
+  under construction does not exceed max_concurrent_states (a larger PDB
+  is built alone). The PDBs are returned in the order of the patterns, so
+  the result does not depend on the number of threads. If symbolic is true,
+  symbolic PDBs are computed (see SymbolicDistances). Otherwise, the PDBs
+  are loaded from and stored in the PDB cache in cache_directory unless it
+  is empty (see pdb_cache.h). The construction time of each PDB is logged
+  at verbose level. Failures to store PDBs in the cache are logged with
+  log_pdb_cache_write_failures.
+*/
+extern std::shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads,
+    int max_concurrent_states,
+    bool symbolic,
+    const std::string &cache_directory,
+    utils::LogProxy &log,
+    const std::function<std::vector<int>(int)> &get_operator_costs = nullptr);
+
+extern void add_symbolic_pdb_option_to_parser(options::OptionParser &parser);
+extern void add_pdb_cache_option_to_parser(options::OptionParser &parser);
+// Report an input error if the PDB cache directory does not exist.
+extern void check_pdb_cache_option(
+    options::OptionParser &parser, const options::Options &opts);
+// Return the PDB cache directory or the empty string if caching is disabled.
+extern std::string get_pdb_cache_directory(const options::Options &opts);
+/*
+  Log a warning if num_failures PDBs could not be stored in the PDB cache,
+  but only the first time this happens in a run. This must be called from
+  the main thread, because logging is not thread-safe (see
+  PatternDatabase::has_cache_write_failed).
+*/
+extern void log_pdb_cache_write_failures(
+    int num_failures, const std::string &cache_directory,
+    utils::LogProxy &log);
+extern void add_pdb_construction_options_to_parser(
+    options::OptionParser &parser);
+
 extern std::string get_rovner_et_al_reference();
 }
 
@@ -1,11 +1,13 @@
 #include "zero_one_pdbs.h"
 
 #include "pattern_database.h"
+#include "utils.h"
 
 #include "../task_proxy.h"
 
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -14,28 +16,63 @@
 using namespace std;
 
 namespace pdbs {
-ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
-    vector<int> remaining_operator_costs;
-    OperatorsProxy operators = task_proxy.get_operators();
-    remaining_operator_costs.reserve(operators.size());
-    for (OperatorProxy op : operators)
-        remaining_operator_costs.push_back(op.get_cost());
-
-    pattern_databases.reserve(patterns.size());
-    for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
-            task_proxy, pattern, remaining_operator_costs);
+static bool is_operator_relevant(
+    const Pattern &pattern, const OperatorProxy &op) {
+    for (EffectProxy effect : op.get_effects()) {
+        int var_id = effect.get_fact().get_variable().get_id();
+        if (binary_search(pattern.begin(), pattern.end(), var_id))
+            return true;
+    }
+    return false;
+}
 
-        /* Set cost of relevant operators to 0 for further iterations
-           (action cost partitioning). */
-        for (OperatorProxy op : operators) {
-            if (pdb->is_operator_relevant(op))
-                remaining_operator_costs[op.get_id()] = 0;
+static PDBCollection compute_zero_one_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, int max_concurrent_states, bool symbolic,
+    const string &cache_directory, utils::LogProxy &log) {
+    /*
+      An operator keeps its cost in the PDBs up to the first pattern it is
+      relevant for and costs 0 in all later ones (action cost partitioning).
+      Since this only depends on the patterns, the PDBs can be computed
+      independently.
+    */
+    OperatorsProxy operators = task_proxy.get_operators();
+    int num_patterns = patterns.size();
+    vector<int> first_relevant_pattern(operators.size(), num_patterns);
+    for (OperatorProxy op : operators) {
+        for (int pattern_id = 0; pattern_id < num_patterns; ++pattern_id) {
+            if (is_operator_relevant(patterns[pattern_id], op)) {
+                first_relevant_pattern[op.get_id()] = pattern_id;
+                break;
+            }
         }
-
-        pattern_databases.push_back(pdb);
     }
+
+    auto get_operator_costs = [&](int pattern_id) {
+            vector<int> operator_costs;
+            operator_costs.reserve(operators.size());
+            for (OperatorProxy op : operators) {
+                if (first_relevant_pattern[op.get_id()] < pattern_id)
+                    operator_costs.push_back(0);
+                else
+                    operator_costs.push_back(op.get_cost());
+            }
+            return operator_costs;
+        };
+    return move(*compute_pdbs(
+                    task_proxy, patterns, num_threads, max_concurrent_states,
+                    symbolic, cache_directory, log, get_operator_costs));
+}
+
+ZeroOnePDBs::ZeroOnePDBs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, int max_concurrent_states, bool symbolic,
+    const string &cache_directory, utils::LogProxy &log)
+    : pattern_databases(compute_zero_one_pdbs(
+                            task_proxy, patterns, num_threads,
+                            max_concurrent_states, symbolic, cache_directory,
+                            log)),
+      lookup(pattern_databases) {
 }
 
 
@@ -46,8 +83,7 @@ int ZeroOnePDBs::get_value(const State &state) const {
     */
     state.unpack();
     int h_val = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state.get_unpacked_values());
+    for (int pdb_value : lookup.compute_values(state.get_unpacked_values())) {
         if (pdb_value == numeric_limits<int>::max())
             return numeric_limits<int>::max();
         h_val += pdb_value;
@@ -1,8 +1,11 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "pdb_lookup.h"
 #include "types.h"
 
+#include <string>
+
 class State;
 class TaskProxy;
 
@@ -13,11 +16,23 @@ class LogProxy;
 namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
+    PDBLookup lookup;
 public:
-    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    /*
+      The PDBs are computed on up to num_threads threads (see
+      compute_pdbs for max_concurrent_states, symbolic and
+      cache_directory).
+    */
+    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns,
+                int num_threads, int max_concurrent_states, bool symbolic,
+                const std::string &cache_directory, utils::LogProxy &log);
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+
+    const PDBCollection &get_pattern_databases() const {
+        return pattern_databases;
+    }
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
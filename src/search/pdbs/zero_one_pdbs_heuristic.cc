@@ -1,6 +1,8 @@
 #include "zero_one_pdbs_heuristic.h"
 
+#include "pattern_database.h"
 #include "pattern_generator.h"
+#include "utils.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -11,7 +13,8 @@ using namespace std;
 
 namespace pdbs {
 ZeroOnePDBs get_zero_one_pdbs_from_options(
-    const shared_ptr<AbstractTask> &task, const Options &opts) {
+    const shared_ptr<AbstractTask> &task, const Options &opts,
+    utils::LogProxy &log) {
     shared_ptr<PatternCollectionGenerator> pattern_generator =
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
     PatternCollectionInformation pattern_collection_info =
@@ -19,13 +22,16 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    return ZeroOnePDBs(task_proxy, *patterns, opts.get<int>("num_threads"),
+                       opts.get<int>("max_concurrent_states"),
+                       opts.get<bool>("symbolic"),
+                       get_pdb_cache_directory(opts), log);
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
     const options::Options &opts)
     : Heuristic(opts),
-      zero_one_pdbs(get_zero_one_pdbs_from_options(task, opts)) {
+      zero_one_pdbs(get_zero_one_pdbs_from_options(task, opts, log)) {
 }
 
 int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -36,6 +42,14 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+bool ZeroOnePDBsHeuristic::get_relevant_variables(set<int> &variables) const {
+    for (const shared_ptr<PatternDatabase> &pdb : zero_one_pdbs.get_pattern_databases()) {
+        const Pattern &pattern = pdb->get_pattern();
+        variables.insert(pattern.begin(), pattern.end());
+    }
+    return true;
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Zero-One PDB",
@@ -60,9 +74,11 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "patterns",
         "pattern generation method",
         "systematic(1)");
+    add_pdb_construction_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
+    check_pdb_cache_option(parser, opts);
     if (parser.dry_run())
         return nullptr;
 
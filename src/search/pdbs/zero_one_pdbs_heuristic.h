@@ -15,6 +15,8 @@ protected:
 public:
     ZeroOnePDBsHeuristic(const options::Options &opts);
     virtual ~ZeroOnePDBsHeuristic() = default;
+
+    virtual bool get_relevant_variables(std::set<int> &variables) const override;
 };
 }
 
@@ -11,6 +11,7 @@
 
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <memory>
@@ -28,7 +29,10 @@ EagerSearch::EagerSearch(const Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      expansion_batch_size(opts.get<int>("expansion_batch_size", 1)),
+      batch_evaluators(
+          opts.get<vector<shared_ptr<Evaluator>>>("batch_evaluators", {})) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -108,25 +112,20 @@ void EagerSearch::print_statistics() const {
     pruning_method->print_statistics();
 }
 
-SearchStatus EagerSearch::step() {
-    tl::optional<SearchNode> node;
-    while (true) {
-        if (open_list->empty()) {
-            log << "Completely explored state space -- no solution!" << endl;
-            return FAILED;
-        }
+tl::optional<SearchNode> EagerSearch::fetch_next_node() {
+    while (!open_list->empty()) {
         StateID id = open_list->remove_min();
         State s = state_registry.lookup_state(id);
-        node.emplace(search_space.get_node(s));
+        SearchNode node = search_space.get_node(s);
 
-        if (node->is_closed())
+        if (node.is_closed())
             continue;
 
         /*
           We can pass calculate_preferred=false here since preferred
           operators are computed when the state is expanded.
         */
-        EvaluationContext eval_context(s, node->get_g(), false, &statistics);
+        EvaluationContext eval_context(s, node.get_g(), false, &statistics);
 
         if (lazy_evaluator) {
             /*
@@ -143,14 +142,14 @@ SearchStatus EagerSearch::step() {
               information in the meantime. Then upon second expansion we have a dead-end
               node which we must ignore.
             */
-            if (node->is_dead_end())
+            if (node.is_dead_end())
                 continue;
 
             if (lazy_evaluator->is_estimate_cached(s)) {
                 int old_h = lazy_evaluator->get_cached_estimate(s);
                 int new_h = eval_context.get_evaluator_value_or_infinity(lazy_evaluator.get());
                 if (open_list->is_dead_end(eval_context)) {
-                    node->mark_as_dead_end();
+                    node.mark_as_dead_end();
                     statistics.inc_dead_ends();
                     continue;
                 }
@@ -161,18 +160,19 @@ SearchStatus EagerSearch::step() {
             }
         }
 
-        node->close();
-        assert(!node->is_dead_end());
+        node.close();
+        assert(!node.is_dead_end());
         update_f_value_statistics(eval_context);
         statistics.inc_expanded();
-        break;
+        return node;
     }
+    return tl::nullopt;
+}
 
-    const State &s = node->get_state();
-    if (check_goal_and_set_plan(s))
-        return SOLVED;
-
-    vector<OperatorID> applicable_ops;
+void EagerSearch::generate_applicable_ops(
+    const SearchNode &node, vector<OperatorID> &applicable_ops,
+    ordered_set::OrderedSet<OperatorID> &preferred_operators) {
+    const State &s = node.get_state();
     successor_generator.generate_applicable_ops(s, applicable_ops);
 
     /*
@@ -182,13 +182,110 @@ SearchStatus EagerSearch::step() {
     pruning_method->prune_operators(s, applicable_ops);
 
     // This evaluates the expanded state (again) to get preferred ops
-    EvaluationContext eval_context(s, node->get_g(), false, &statistics, true);
-    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
     for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
         collect_preferred_operators(eval_context,
                                     preferred_operator_evaluator.get(),
                                     preferred_operators);
     }
+}
+
+void EagerSearch::process_successor(
+    const SearchNode &node, const OperatorProxy &op,
+    const State &succ_state, bool is_preferred) {
+    SearchNode succ_node = search_space.get_node(succ_state);
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (succ_node.is_dead_end())
+        return;
+
+    if (succ_node.is_new()) {
+        // We have not seen this state before.
+        // Evaluate and create a new node.
+
+        // Careful: succ_node.get_g() is not available here yet,
+        // hence the stupid computation of succ_g.
+        // TODO: Make this less fragile.
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+
+        EvaluationContext succ_eval_context(
+            succ_state, succ_g, is_preferred, &statistics);
+        statistics.inc_evaluated_states();
+
+        if (open_list->is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return;
+        }
+        succ_node.open(node, op, get_adjusted_cost(op));
+
+        open_list->insert(succ_eval_context, succ_state.get_id());
+        if (search_progress.check_progress(succ_eval_context)) {
+            statistics.print_checkpoint_line(succ_node.get_g());
+            reward_progress();
+        }
+    } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
+        // We found a new cheapest path to an open or closed state.
+        if (reopen_closed_nodes) {
+            if (succ_node.is_closed()) {
+                /*
+                  TODO: It would be nice if we had a way to test
+                  that reopening is expected behaviour, i.e., exit
+                  with an error when this is something where
+                  reopening should not occur (e.g. A* with a
+                  consistent heuristic).
+                */
+                statistics.inc_reopened();
+            }
+            succ_node.reopen(node, op, get_adjusted_cost(op));
+
+            EvaluationContext succ_eval_context(
+                succ_state, succ_node.get_g(), is_preferred, &statistics);
+
+            /*
+              Note: our old code used to retrieve the h value from
+              the search node here. Our new code recomputes it as
+              necessary, thus avoiding the incredible ugliness of
+              the old "set_evaluator_value" approach, which also
+              did not generalize properly to settings with more
+              than one evaluator.
+
+              Reopening should not happen all that frequently, so
+              the performance impact of this is hopefully not that
+              large. In the medium term, we want the evaluators to
+              remember evaluator values for states themselves if
+              desired by the user, so that such recomputations
+              will just involve a look-up by the Evaluator object
+              rather than a recomputation of the evaluator value
+              from scratch.
+            */
+            open_list->insert(succ_eval_context, succ_state.get_id());
+        } else {
+            // If we do not reopen closed nodes, we just update the parent pointers.
+            // Note that this could cause an incompatibility between
+            // the g-value and the actual path that is traced back.
+            succ_node.update_parent(node, op, get_adjusted_cost(op));
+        }
+    }
+}
+
+SearchStatus EagerSearch::step() {
+    if (expansion_batch_size > 1)
+        return step_batched();
+
+    tl::optional<SearchNode> node = fetch_next_node();
+    if (!node) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+
+    const State &s = node->get_state();
+    if (check_goal_and_set_plan(s))
+        return SOLVED;
+
+    vector<OperatorID> applicable_ops;
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    generate_applicable_ops(*node, applicable_ops, preferred_operators);
 
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
@@ -199,86 +296,120 @@ SearchStatus EagerSearch::step() {
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
-        SearchNode succ_node = search_space.get_node(succ_state);
-
         for (Evaluator *evaluator : path_dependent_evaluators) {
             evaluator->notify_state_transition(s, op_id, succ_state);
         }
 
-        // Previously encountered dead end. Don't re-evaluate.
-        if (succ_node.is_dead_end())
-            continue;
+        process_successor(*node, op, succ_state, is_preferred);
+    }
 
-        if (succ_node.is_new()) {
-            // We have not seen this state before.
-            // Evaluate and create a new node.
+    return IN_PROGRESS;
+}
 
-            // Careful: succ_node.get_g() is not available here yet,
-            // hence the stupid computation of succ_g.
-            // TODO: Make this less fragile.
-            int succ_g = node->get_g() + get_adjusted_cost(op);
+SearchStatus EagerSearch::step_batched() {
+    /*
+      Expand up to expansion_batch_size nodes and collect all their
+      successors before evaluating any of them. Duplicates within the
+      batch are detected in bulk by sorting the successors by state ID,
+      which also makes the subsequent accesses to the per-state search
+      information sequential.
+    */
+    assert(batch_nodes.empty() && batch_successors.empty());
+    vector<OperatorID> applicable_ops;
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    while (static_cast<int>(batch_nodes.size()) < expansion_batch_size) {
+        tl::optional<SearchNode> node = fetch_next_node();
+        if (!node)
+            break;
+
+        const State &s = node->get_state();
+        if (check_goal_and_set_plan(s)) {
+            batch_nodes.clear();
+            batch_successors.clear();
+            return SOLVED;
+        }
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
-            statistics.inc_evaluated_states();
+        applicable_ops.clear();
+        preferred_operators.clear();
+        generate_applicable_ops(*node, applicable_ops, preferred_operators);
 
-            if (open_list->is_dead_end(succ_eval_context)) {
-                succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
+        int node_index = batch_nodes.size();
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if ((node->get_real_g() + op.get_cost()) >= bound)
                 continue;
-            }
-            succ_node.open(*node, op, get_adjusted_cost(op));
 
-            open_list->insert(succ_eval_context, succ_state.get_id());
-            if (search_progress.check_progress(succ_eval_context)) {
-                statistics.print_checkpoint_line(succ_node.get_g());
-                reward_progress();
+            State succ_state = state_registry.get_successor_state(s, op);
+            statistics.inc_generated();
+            int succ_g = node->get_g() + get_adjusted_cost(op);
+            batch_successors.push_back(
+                {succ_state.get_id(), succ_g, node_index, op_id,
+                 preferred_operators.contains(op_id)});
+
+            for (Evaluator *evaluator : path_dependent_evaluators) {
+                evaluator->notify_state_transition(s, op_id, succ_state);
             }
-        } else if (succ_node.get_g() > node->get_g() + get_adjusted_cost(op)) {
-            // We found a new cheapest path to an open or closed state.
-            if (reopen_closed_nodes) {
-                if (succ_node.is_closed()) {
-                    /*
-                      TODO: It would be nice if we had a way to test
-                      that reopening is expected behaviour, i.e., exit
-                      with an error when this is something where
-                      reopening should not occur (e.g. A* with a
-                      consistent heuristic).
-                    */
-                    statistics.inc_reopened();
-                }
-                succ_node.reopen(*node, op, get_adjusted_cost(op));
+        }
+        batch_nodes.push_back(move(*node));
+    }
 
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
+    if (batch_nodes.empty()) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
 
-                /*
-                  Note: our old code used to retrieve the h value from
-                  the search node here. Our new code recomputes it as
-                  necessary, thus avoiding the incredible ugliness of
-                  the old "set_evaluator_value" approach, which also
-                  did not generalize properly to settings with more
-                  than one evaluator.
-
-                  Reopening should not happen all that frequently, so
-                  the performance impact of this is hopefully not that
-                  large. In the medium term, we want the evaluators to
-                  remember evaluator values for states themselves if
-                  desired by the user, so that such recomputations
-                  will just involve a look-up by the Evaluator object
-                  rather than a recomputation of the evaluator value
-                  from scratch.
-                */
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            } else {
-                // If we do not reopen closed nodes, we just update the parent pointers.
-                // Note that this could cause an incompatibility between
-                // the g-value and the actual path that is traced back.
-                succ_node.update_parent(*node, op, get_adjusted_cost(op));
-            }
+    /*
+      Among several transitions to the same state, we only process the
+      cheapest one (the first generated one among equally cheap ones).
+      The others cannot lead to a change in the search space afterwards,
+      except that the state counts as reached by a preferred operator if
+      any of the transitions uses one.
+    */
+    stable_sort(batch_successors.begin(), batch_successors.end(),
+                [](const BatchSuccessor &lhs, const BatchSuccessor &rhs) {
+                    if (lhs.state_id != rhs.state_id)
+                        return lhs.state_id < rhs.state_id;
+                    return lhs.g < rhs.g;
+                });
+    for (size_t i = 0; i < batch_successors.size();) {
+        size_t j = i + 1;
+        while (j < batch_successors.size() &&
+               batch_successors[j].state_id == batch_successors[i].state_id) {
+            if (batch_successors[j].is_preferred)
+                batch_successors[i].is_preferred = true;
+            ++j;
         }
+        i = j;
+    }
+    batch_successors.erase(
+        unique(batch_successors.begin(), batch_successors.end(),
+               [](const BatchSuccessor &lhs, const BatchSuccessor &rhs) {
+                   return lhs.state_id == rhs.state_id;
+               }),
+        batch_successors.end());
+
+    for (const BatchSuccessor &succ : batch_successors) {
+        batch_states.push_back(state_registry.lookup_state(succ.state_id));
+        if (search_space.get_node(batch_states.back()).is_new())
+            batch_new_states.push_back(batch_states.back());
+    }
+    if (!batch_new_states.empty()) {
+        for (const shared_ptr<Evaluator> &evaluator : batch_evaluators)
+            evaluator->precompute_estimates(batch_new_states);
     }
 
+    for (size_t i = 0; i < batch_successors.size(); ++i) {
+        const BatchSuccessor &succ = batch_successors[i];
+        process_successor(
+            batch_nodes[succ.parent_index],
+            task_proxy.get_operators()[succ.op_id],
+            batch_states[i], succ.is_preferred);
+    }
+
+    batch_nodes.clear();
+    batch_successors.clear();
+    batch_states.clear();
+    batch_new_states.clear();
     return IN_PROGRESS;
 }
 
@@ -308,6 +439,19 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
     }
 }
 
+void add_expansion_batch_size_option(OptionParser &parser) {
+    parser.add_option<int>(
+        "expansion_batch_size",
+        "number of nodes expanded before their successors are evaluated. "
+        "With values larger than 1, the successors of all nodes of a batch "
+        "are generated first, duplicates among them are eliminated in bulk "
+        "and only then the remaining successors are evaluated. Evaluators "
+        "that support it (e.g. relaxed_reachability) then compute the "
+        "estimates of all new successors of the batch at once.",
+        "1",
+        Bounds("1", "infinity"));
+}
+
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
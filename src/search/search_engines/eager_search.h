@@ -4,7 +4,10 @@
 #include "../open_list.h"
 #include "../search_engine.h"
 
+#include "../algorithms/ordered_set.h"
+
 #include <memory>
+#include <optional.hh>
 #include <vector>
 
 class Evaluator;
@@ -28,6 +31,36 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    const int expansion_batch_size;
+    /*
+      Evaluators that are asked to precompute the estimates of all new
+      successors of a batch at once (option "batch_evaluators", which is
+      set by plugins that support batches).
+    */
+    std::vector<std::shared_ptr<Evaluator>> batch_evaluators;
+
+    struct BatchSuccessor {
+        StateID state_id;
+        int g;
+        int parent_index;
+        OperatorID op_id;
+        bool is_preferred;
+    };
+    // Buffers used by step_batched(); empty between steps.
+    std::vector<SearchNode> batch_nodes;
+    std::vector<BatchSuccessor> batch_successors;
+    std::vector<State> batch_states;
+    std::vector<State> batch_new_states;
+
+    tl::optional<SearchNode> fetch_next_node();
+    void generate_applicable_ops(
+        const SearchNode &node, std::vector<OperatorID> &applicable_ops,
+        ordered_set::OrderedSet<OperatorID> &preferred_operators);
+    void process_successor(
+        const SearchNode &node, const OperatorProxy &op,
+        const State &succ_state, bool is_preferred);
+    SearchStatus step_batched();
+
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -45,6 +78,7 @@ public:
     void dump_search_space() const;
 };
 
+extern void add_expansion_batch_size_option(options::OptionParser &parser);
 extern void add_options_to_parser(options::OptionParser &parser);
 }
 
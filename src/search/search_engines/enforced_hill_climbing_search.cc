@@ -9,9 +9,12 @@
 #include "../open_lists/best_first_open_list.h"
 #include "../open_lists/tiebreaking_open_list.h"
 #include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 #include "../utils/system.h"
 
+#include <algorithm>
+
 using namespace std;
 using utils::ExitCode;
 
@@ -75,6 +78,7 @@ EnforcedHillClimbingSearch::EnforcedHillClimbingSearch(
       preferred_usage(opts.get<PreferredUsage>("preferred_usage")),
       current_eval_context(state_registry.get_initial_state(), &statistics),
       current_phase_start_g(-1),
+      current_epoch(-1),
       num_ehc_phases(0),
       last_num_expanded(-1) {
     for (const shared_ptr<Evaluator> &eval : preferred_operator_evaluators) {
@@ -126,10 +130,35 @@ void EnforcedHillClimbingSearch::initialize() {
             utils::exit_with(ExitCode::SEARCH_UNSOLVED_INCOMPLETE);
     }
 
-    SearchNode node = search_space.get_node(current_eval_context.get_state());
-    node.open_initial();
+    start_phase(current_eval_context.get_state(), 0, 0);
+}
+
+int EnforcedHillClimbingSearch::add_phase_node(
+    const State &state, int parent_index, OperatorID op_id, int g, int real_g) {
+    int node_index = phase_nodes.size();
+    phase_nodes.push_back({state.get_id(), parent_index, op_id, g, real_g});
+    PhaseStamp &stamp = phase_stamps[state];
+    stamp.epoch = current_epoch;
+    stamp.node_index = node_index;
+    return node_index;
+}
 
-    current_phase_start_g = 0;
+void EnforcedHillClimbingSearch::start_phase(
+    const State &state, int g, int real_g) {
+    ++current_epoch;
+    phase_nodes.clear();
+    open_list->clear();
+    current_phase_start_g = g;
+    add_phase_node(state, -1, OperatorID::no_operator, g, real_g);
+}
+
+void EnforcedHillClimbingSearch::extend_plan_prefix(int node_index) {
+    size_t old_size = plan_prefix.size();
+    for (int index = node_index; phase_nodes[index].parent_index != -1;
+         index = phase_nodes[index].parent_index) {
+        plan_prefix.push_back(phase_nodes[index].creating_operator);
+    }
+    reverse(plan_prefix.begin() + old_size, plan_prefix.end());
 }
 
 void EnforcedHillClimbingSearch::insert_successor_into_open_list(
@@ -147,9 +176,9 @@ void EnforcedHillClimbingSearch::insert_successor_into_open_list(
     statistics.inc_generated_ops();
 }
 
-void EnforcedHillClimbingSearch::expand(EvaluationContext &eval_context) {
-    SearchNode node = search_space.get_node(eval_context.get_state());
-    int node_g = node.get_g();
+void EnforcedHillClimbingSearch::expand(
+    EvaluationContext &eval_context, int node_index) {
+    int node_g = phase_nodes[node_index].g;
 
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     if (use_preferred) {
@@ -180,18 +209,20 @@ void EnforcedHillClimbingSearch::expand(EvaluationContext &eval_context) {
     }
 
     statistics.inc_expanded();
-    node.close();
 }
 
 SearchStatus EnforcedHillClimbingSearch::step() {
     last_num_expanded = statistics.get_expanded();
     search_progress.check_progress(current_eval_context);
 
-    if (check_goal_and_set_plan(current_eval_context.get_state())) {
+    if (task_properties::is_goal_state(
+            task_proxy, current_eval_context.get_state())) {
+        log << "Solution found!" << endl;
+        set_plan(plan_prefix);
         return SOLVED;
     }
 
-    expand(current_eval_context);
+    expand(current_eval_context, 0);
     return ehc();
 }
 
@@ -203,50 +234,57 @@ SearchStatus EnforcedHillClimbingSearch::ehc() {
         OperatorProxy last_op = task_proxy.get_operators()[last_op_id];
 
         State parent_state = state_registry.lookup_state(parent_state_id);
-        SearchNode parent_node = search_space.get_node(parent_state);
+        const PhaseStamp &parent_stamp = phase_stamps[parent_state];
+        assert(parent_stamp.epoch == current_epoch);
+        int parent_index = parent_stamp.node_index;
+        int parent_g = phase_nodes[parent_index].g;
+        int parent_real_g = phase_nodes[parent_index].real_g;
 
         // d: distance from initial node in this EHC phase
-        int d = parent_node.get_g() - current_phase_start_g +
+        int d = parent_g - current_phase_start_g +
             get_adjusted_cost(last_op);
 
-        if (parent_node.get_real_g() + last_op.get_cost() >= bound)
+        if (parent_real_g + last_op.get_cost() >= bound)
             continue;
 
         State state = state_registry.get_successor_state(parent_state, last_op);
         statistics.inc_generated();
 
-        SearchNode node = search_space.get_node(state);
+        if (phase_stamps[state].epoch == current_epoch)
+            continue;
 
-        if (node.is_new()) {
-            EvaluationContext eval_context(state, &statistics);
-            reach_state(parent_state, last_op_id, state);
-            statistics.inc_evaluated_states();
+        int node_index = add_phase_node(
+            state, parent_index, last_op_id,
+            parent_g + get_adjusted_cost(last_op),
+            parent_real_g + last_op.get_cost());
 
-            if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
-                node.mark_as_dead_end();
-                statistics.inc_dead_ends();
-                continue;
-            }
+        EvaluationContext eval_context(state, &statistics);
+        reach_state(parent_state, last_op_id, state);
+        statistics.inc_evaluated_states();
+
+        if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            statistics.inc_dead_ends();
+            continue;
+        }
+
+        int h = eval_context.get_evaluator_value(evaluator.get());
 
-            int h = eval_context.get_evaluator_value(evaluator.get());
-            node.open(parent_node, last_op, get_adjusted_cost(last_op));
-
-            if (h < current_eval_context.get_evaluator_value(evaluator.get())) {
-                ++num_ehc_phases;
-                if (d_counts.count(d) == 0) {
-                    d_counts[d] = make_pair(0, 0);
-                }
-                pair<int, int> &d_pair = d_counts[d];
-                d_pair.first += 1;
-                d_pair.second += statistics.get_expanded() - last_num_expanded;
-
-                current_eval_context = move(eval_context);
-                open_list->clear();
-                current_phase_start_g = node.get_g();
-                return IN_PROGRESS;
-            } else {
-                expand(eval_context);
+        if (h < current_eval_context.get_evaluator_value(evaluator.get())) {
+            ++num_ehc_phases;
+            if (d_counts.count(d) == 0) {
+                d_counts[d] = make_pair(0, 0);
             }
+            pair<int, int> &d_pair = d_counts[d];
+            d_pair.first += 1;
+            d_pair.second += statistics.get_expanded() - last_num_expanded;
+
+            extend_plan_prefix(node_index);
+            PhaseNode node = phase_nodes[node_index];
+            current_eval_context = move(eval_context);
+            start_phase(current_eval_context.get_state(), node.g, node.real_g);
+            return IN_PROGRESS;
+        } else {
+            expand(eval_context, node_index);
         }
     }
     log << "No solution - FAILED" << endl;
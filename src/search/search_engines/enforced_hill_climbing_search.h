@@ -3,6 +3,7 @@
 
 #include "../evaluation_context.h"
 #include "../open_list.h"
+#include "../per_state_information.h"
 #include "../search_engine.h"
 
 #include <map>
@@ -24,6 +25,14 @@ enum class PreferredUsage {
 /*
   Enforced hill-climbing with deferred evaluation.
 
+  Each improvement phase is a breadth-first search from the best state
+  found so far. The phases do not use the global search space: states
+  visited in the current phase are recognized by an epoch stamp stored per
+  state, so starting a new phase only increments the epoch. The parent
+  pointers of the current phase are kept in a vector that is reused by
+  the next phase. Once a phase finds an improving state, the path to it
+  is appended to the plan prefix.
+
   TODO: We should test if this lazy implementation really has any benefits over
   an eager one. We hypothesize that both versions need to evaluate and store
   the same states anyways.
@@ -39,6 +48,22 @@ class EnforcedHillClimbingSearch : public SearchEngine {
 
     EvaluationContext current_eval_context;
     int current_phase_start_g;
+    Plan plan_prefix;
+
+    struct PhaseNode {
+        StateID state_id;
+        int parent_index;
+        OperatorID creating_operator;
+        int g;
+        int real_g;
+    };
+    struct PhaseStamp {
+        int epoch = -1;
+        int node_index = -1;
+    };
+    std::vector<PhaseNode> phase_nodes;
+    PerStateInformation<PhaseStamp> phase_stamps;
+    int current_epoch;
 
     // Statistics
     std::map<int, std::pair<int, int>> d_counts;
@@ -50,9 +75,13 @@ class EnforcedHillClimbingSearch : public SearchEngine {
         int parent_g,
         OperatorID op_id,
         bool preferred);
-    void expand(EvaluationContext &eval_context);
+    void expand(EvaluationContext &eval_context, int node_index);
     void reach_state(
         const State &parent, OperatorID op_id, const State &state);
+    int add_phase_node(
+        const State &state, int parent_index, OperatorID op_id, int g, int real_g);
+    void start_phase(const State &state, int g, int real_g);
+    void extend_plan_prefix(int node_index);
     SearchStatus ehc();
 
 protected:
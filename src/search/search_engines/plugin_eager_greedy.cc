@@ -54,6 +54,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<int>(
         "boost",
         "boost value for preferred operator open lists", "0");
+    eager_search::add_expansion_batch_size_option(parser);
 
     eager_search::add_options_to_parser(parser);
     Options opts = parser.parse();
@@ -65,6 +66,9 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         opts.set("reopen_closed", false);
         shared_ptr<Evaluator> evaluator = nullptr;
         opts.set("f_eval", evaluator);
+        // Evaluate the successors of a batch at once for all open list evaluators.
+        opts.set("batch_evaluators",
+                 opts.get_list<shared_ptr<Evaluator>>("evals"));
         engine = make_shared<eager_search::EagerSearch>(opts);
     }
     return engine;
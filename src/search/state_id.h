@@ -35,6 +35,11 @@ public:
     bool operator!=(const StateID &other) const {
         return !(*this == other);
     }
+
+    // Orders states by registration time (useful for sorting and bulk processing).
+    bool operator<(const StateID &other) const {
+        return value < other.value;
+    }
 };
 
 
@@ -0,0 +1,33 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void parallel_for(
+    int num_tasks, int num_threads, const function<void(int)> &task) {
+    num_threads = min(num_threads, num_tasks);
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_tasks; ++i)
+            task(i);
+        return;
+    }
+
+    atomic<int> next_task(0);
+    auto run_tasks = [&]() {
+            for (int i = next_task++; i < num_tasks; i = next_task++)
+                task(i);
+        };
+    vector<thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int i = 0; i < num_threads - 1; ++i)
+        workers.emplace_back(run_tasks);
+    run_tasks();
+    for (thread &worker : workers)
+        worker.join();
+}
+}
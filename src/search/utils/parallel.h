@@ -0,0 +1,22 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace utils {
+/*
+  Call task(i) for all 0 <= i < num_tasks on up to num_threads threads,
+  one of which is the calling thread. Tasks are started in order of
+  increasing index, but run concurrently and may finish in any order, so
+  a task should only write to data that belongs to its index. Results
+  are therefore independent of the number of threads as long as the tasks
+  are. The function returns when all tasks are done.
+
+  The log and most other components of the planner are not thread-safe,
+  so tasks should only read shared data.
+*/
+extern void parallel_for(
+    int num_tasks, int num_threads, const std::function<void(int)> &task);
+}
+
+#endif